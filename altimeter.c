@@ -1,5 +1,6 @@
 #include "altimeter.h"
-#include "circBufT.h"
+#include "circBufStats.h"
+#include "medianFilter.h"
 
 /* *****************************************************************************
  * altimeter.c
@@ -17,7 +18,10 @@
 #include "inc/hw_memmap.h"
 #include "inc/hw_types.h"
 #include "inc/hw_ints.h"
+#include "inc/hw_adc.h"
 #include "driverlib/adc.h"
+#include "driverlib/timer.h"
+#include "driverlib/udma.h"
 #include "driverlib/gpio.h"
 #include "driverlib/sysctl.h"
 #include "driverlib/interrupt.h"
@@ -27,80 +31,762 @@
 /* *****************************************************************************
  * Globals to module
  */
-static circBuf_t g_altitudeBuffer;
-static uint8_t g_sampleCount;
+CIRCBUF_STATIC_DEFINE(U16, g_altitudeBuffer, BUF_SIZE_LOG2);
+CIRCBUF_STATS_DEFINE(g_altitudeStats, BUF_SIZE_LOG2);
+#if ALT_FILTER_MODE == ALT_FILTER_MEDIAN
+MEDIAN_FILTER_DEFINE(g_altitudeMedian, BUF_SIZE_LOG2);
+#elif ALT_FILTER_MODE == ALT_FILTER_IIR
+static cicDecimator_t g_altitudeCic;
+static iirFilter_t g_altitudeIir;
+static volatile int32_t g_altitudeIirOutput; // ADC counts with ALT_IIR_FRAC_BITS fractional bits
+#endif
+static volatile uint32_t g_sampleCount; // saturates at BUF_SIZE
+
+// g_sampleCount must hold BUF_SIZE, and BUF_SIZE * 100 for the calibration
+// progress
+#if BUF_SIZE_LOG2 > 25
+#error "BUF_SIZE_LOG2 is too large for g_sampleCount"
+#endif
+
+// Alpha-beta estimator state, in Q16 ADC counts and Q16 ADC counts per sample
+static int32_t g_altEstimate;
+static volatile int32_t g_altRateEstimate;
 static uint32_t g_minAltADCValue;
 static uint32_t g_maxAltADCValue;
 
+// Q16 ADC-to-altitude conversion, precomputed when calibration completes. The
+// ISR fills the inactive slot and then switches to it, so a reader in the main
+// loop never sees a scale and offset from different calibrations.
+typedef struct {
+	uint32_t percentScale;
+	uint32_t percentOffset;
+	uint32_t tenthsScale;
+	uint32_t tenthsOffset;
+} altCalibration_t;
+
+static altCalibration_t g_altCalibrations[2];
+static volatile uint8_t g_altCalibrationSlot;
+static volatile bool g_altCalibrationPending;
+static volatile uint32_t g_altRestoredADCValue; // ground value to confirm, or 0
+
+#if ALT_ACQ_MODE == ALT_ACQ_DMA
+// uDMA control table, which must be 1024-byte aligned
+#if defined(ccs)
+#pragma DATA_ALIGN(g_DMAControlTable, 1024)
+static uint8_t g_DMAControlTable[1024];
+#else
+static uint8_t g_DMAControlTable[1024] __attribute__ ((aligned(1024)));
+#endif
+
+static uint16_t g_pingBlock[ALT_DMA_BLOCK_SIZE];
+static uint16_t g_pongBlock[ALT_DMA_BLOCK_SIZE];
+#endif
+static volatile uint32_t g_blockCount;
+
+// Digital comparator limits, one comparator per altitudeLimit_t
+static uint16_t g_altLimitPercent[NUM_ALT_LIMITS];
+static uint32_t g_altLimitThreshold[NUM_ALT_LIMITS]; // ADC counts, 0 until calibrated
+static volatile bool g_altLimitActive[NUM_ALT_LIMITS];
+static volatile bool g_altLimitEvent[NUM_ALT_LIMITS];
+
+
+/* *****************************************************************************
+ * getFilteredAltADCValue: returns the altitude ADC value after filtering the
+ * circular buffer (or the stored samples, for ALT_FILTER_IIR), as selected by
+ * ALT_FILTER_MODE.
+ */
+static uint32_t
+getFilteredAltADCValue (void)
+{
+#if ALT_FILTER_MODE == ALT_FILTER_MEDIAN
+    return medianFilterValue(&g_altitudeMedian);
+#elif ALT_FILTER_MODE == ALT_FILTER_IIR
+    return (g_altitudeIirOutput + (1 << (ALT_IIR_FRAC_BITS - 1))) >> ALT_IIR_FRAC_BITS;
+#else
+    return circBufU16Mean(&g_altitudeBuffer);
+#endif
+}
+
+
+/* *****************************************************************************
+ * convertAltADCValue: converts an altitude ADC value with a Q16 scale and offset
+ * from the current calibration. A higher altitude gives a lower ADC value, so
+ * the scaled value is subtracted from the offset. Values below the ground
+ * (calibrated) altitude are returned as 0.
+ */
+static uint32_t
+convertAltADCValue (uint32_t ADCValue, uint32_t scale, uint32_t offset)
+{
+	uint32_t scaled = ADCValue * scale;
+
+	if (scaled >= offset) {
+		return 0;
+	}
+	return (offset - scaled) >> ALT_SCALE_SHIFT;
+}
+
 
 /* *****************************************************************************
  * getCurrentAltitude: calculates and returns the current altitude based on the
- * average of the circular buffer. The returned value is a percentage based on
- * the expected input voltage range - 0% representing the lowest altitude, 100%
- * the highest. Returned value may exceed 100 (the result of equipment
- * variation).
+ * filtered altitude ADC values (see ALT_FILTER_MODE). The returned value is a
+ * percentage based on the expected input voltage range - 0% representing the
+ * lowest altitude, 100% the highest. Returned value may exceed 100 (the result
+ * of equipment variation).
  */
 uint16_t
 getCurrentAltitude (void)
 {
-    uint32_t currentAltADCValue = circBufMean(&g_altitudeBuffer);
-    int32_t altPercNum = (currentAltADCValue - g_maxAltADCValue) * 100;
-    int32_t altPercDenom = g_maxAltADCValue - g_minAltADCValue;
+	const altCalibration_t *calibration = &g_altCalibrations[g_altCalibrationSlot];
+	return convertAltADCValue(getFilteredAltADCValue(), calibration->percentScale,
+			calibration->percentOffset);
+}
+
+
+/* *****************************************************************************
+ * getCurrentAltitudeTenths: as for getCurrentAltitude, but in tenths of a
+ * percent (1000 representing the highest altitude).
+ */
+int32_t
+getCurrentAltitudeTenths (void)
+{
+	const altCalibration_t *calibration = &g_altCalibrations[g_altCalibrationSlot];
+	return convertAltADCValue(getFilteredAltADCValue(), calibration->tenthsScale,
+			calibration->tenthsOffset);
+}
+
+
+/* *****************************************************************************
+ * getAltitudeClimbRate: returns the rate of climb in tenths of a percent per
+ * second, as estimated by an alpha-beta filter over the raw samples. It lags a
+ * slow change by about alpha / beta (8) samples, where differencing
+ * getCurrentAltitude lags by half the filter window.
+ */
+int32_t
+getAltitudeClimbRate (void)
+{
+	const altCalibration_t *calibration = &g_altCalibrations[g_altCalibrationSlot];
+
+	// A higher altitude gives a lower ADC value, hence the negation
+	int64_t rate = -(int64_t)g_altRateEstimate * ALT_SAMPLE_RATE * calibration->tenthsScale;
+	return (int32_t)(rate >> (2 * ALT_SCALE_SHIFT));
+}
+
+
+/* *****************************************************************************
+ * getAltitudeADCMin: returns the smallest ADC value in the altitude window.
+ * Note that a higher altitude gives a lower ADC value.
+ */
+uint16_t
+getAltitudeADCMin (void)
+{
+    return circBufStatsMin(&g_altitudeStats);
+}
+
+
+/* *****************************************************************************
+ * getAltitudeADCMax: returns the largest ADC value in the altitude window.
+ */
+uint16_t
+getAltitudeADCMax (void)
+{
+    return circBufStatsMax(&g_altitudeStats);
+}
+
+
+/* *****************************************************************************
+ * getAltitudeNoise: returns the variance of the ADC values in the altitude
+ * window, in ADC counts squared. May be used to detect sensor faults.
+ */
+uint32_t
+getAltitudeNoise (void)
+{
+    return circBufStatsVariance(&g_altitudeStats);
+}
+
+
+/* *****************************************************************************
+ * openAltitudeStream: attaches reader to the buffer of raw altitude ADC
+ * samples, so that consumers such as loggers can follow the samples at their
+ * own rate without copying them. Samples are read with readCircBufU16Reader.
+ */
+void
+openAltitudeStream (circBufU16Reader_t *reader, circBufOverrunPolicy_t policy)
+{
+    initCircBufU16Reader(reader, &g_altitudeBuffer, policy);
+}
+
+
+/* *****************************************************************************
+ * readAltitudeADC: if a conversion has completed, stores its value in *sample,
+ * triggers the next conversion and returns true. Otherwise returns false.
+ */
+static bool
+readAltitudeADC (uint32_t *sample)
+{
+#if ALT_ACQ_MODE == ALT_ACQ_DMA
+	return false; // Stored by altitudeDMAIntHandler
+#elif ALT_ACQ_MODE == ALT_ACQ_OVERSAMPLED
+	if (!ADCIntStatus(ALTITUDE_ADC_BASE, ALT_BATCH_SEQUENCER, false)) {
+		return false;
+	}
+	ADCIntClear(ALTITUDE_ADC_BASE, ALT_BATCH_SEQUENCER);
+
+	uint32_t ADCSampleBuffer[ALT_BATCH_STEPS];
+	uint32_t batchSum = 0;
+	int32_t i;
+	int32_t count = ADCSequenceDataGet(ALTITUDE_ADC_BASE, ALT_BATCH_SEQUENCER, ADCSampleBuffer);
+	for (i = 0; i < count; i++) {
+		batchSum += ADCSampleBuffer[i];
+	}
+	ADCProcessorTrigger(ALTITUDE_ADC_BASE, ALT_BATCH_SEQUENCER);
+
+	if (count != ALT_BATCH_STEPS) {
+		return false; // Incomplete batch, skip it
+	}
+	*sample = (batchSum + ALT_BATCH_STEPS / 2) >> ALT_BATCH_STEPS_LOG2;
+	return true;
+#else
+	if (!ADCIntStatus(ALTITUDE_ADC_BASE, ALT_SINGLE_SEQUENCER, false)) {
+		return false;
+	}
+	ADCIntClear(ALTITUDE_ADC_BASE, ALT_SINGLE_SEQUENCER);
+
+	uint32_t ADCSampleBuffer[1];
+	ADCSequenceDataGet(ALTITUDE_ADC_BASE, ALT_SINGLE_SEQUENCER, ADCSampleBuffer);
+	ADCProcessorTrigger(ALTITUDE_ADC_BASE, ALT_SINGLE_SEQUENCER);
+
+	*sample = ADCSampleBuffer[0];
+	return true;
+#endif
+}
+
+
+/* *****************************************************************************
+ * armAltitudeLimit: sets the comparator for a limit to interrupt on the next
+ * crossing - into the limit if inactive, out of it (past the hysteresis) if
+ * active. A higher altitude gives a lower ADC value, so the ground limit is
+ * the high ADC band and the ceiling the low band.
+ */
+static void
+armAltitudeLimit (altitudeLimit_t limit)
+{
+	uint32_t threshold = g_altLimitThreshold[limit];
+	bool insideHigh = (limit == ALT_LIMIT_GROUND);
+	bool watchHigh = (insideHigh != g_altLimitActive[limit]);
+
+	if (threshold == 0) {
+		ADCComparatorConfigure(ALTITUDE_ADC_BASE, limit, ADC_COMP_INT_NONE);
+		return;
+	}
+	if (g_altLimitActive[limit]) {
+		threshold = insideHigh ? threshold - ALT_LIMIT_HYSTERESIS : threshold + ALT_LIMIT_HYSTERESIS;
+	}
+
+	ADCComparatorRegionSet(ALTITUDE_ADC_BASE, limit, threshold, threshold);
+	ADCComparatorConfigure(ALTITUDE_ADC_BASE, limit,
+			watchHigh ? ADC_COMP_INT_HIGH_ONCE : ADC_COMP_INT_LOW_ONCE);
+	ADCComparatorReset(ALTITUDE_ADC_BASE, limit, true, true);
+}
+
+
+/* *****************************************************************************
+ * programAltitudeLimits: converts the limit percentages to ADC thresholds with
+ * the current calibration, and re-arms the comparators.
+ */
+static void
+programAltitudeLimits (void)
+{
+	uint32_t range = g_minAltADCValue - g_maxAltADCValue;
+	uint32_t i;
+
+	for (i = 0; i < NUM_ALT_LIMITS; i++) {
+		uint32_t span = (g_altLimitPercent[i] * range + 50) / 100;
+		if (g_minAltADCValue == 0) {
+			g_altLimitThreshold[i] = 0; // Not yet calibrated
+		} else {
+			g_altLimitThreshold[i] = (span < g_minAltADCValue) ? g_minAltADCValue - span : 1;
+		}
+		armAltitudeLimit(i);
+	}
+}
+
+
+/* *****************************************************************************
+ * altitudeLimitIntHandler: called when a digital comparator detects a limit
+ * crossing. Toggles the limit state, records entries as events, and re-arms the
+ * comparator for the opposite crossing.
+ */
+void
+altitudeLimitIntHandler (void)
+{
+	uint32_t status = ADCComparatorIntStatus(ALTITUDE_ADC_BASE);
+	uint32_t i;
 
-    uint16_t currentAlt = MAX(0, (2 * altPercNum - altPercDenom) / (2 * altPercDenom) + 100);
-    return currentAlt;
+	ADCComparatorIntClear(ALTITUDE_ADC_BASE, status);
+	for (i = 0; i < NUM_ALT_LIMITS; i++) {
+		if (status & (1 << i)) {
+			g_altLimitActive[i] = !g_altLimitActive[i];
+			if (g_altLimitActive[i]) {
+				g_altLimitEvent[i] = true;
+			}
+			armAltitudeLimit(i);
+		}
+	}
+}
+
+
+/* *****************************************************************************
+ * completeAltimeterCalibration: takes groundADCValue as the ground (minimum)
+ * altitude, and precomputes the scales and offsets used to convert ADC values
+ * to altitudes. Called from the ISR that stores samples.
+ */
+static void
+completeAltimeterCalibration (uint32_t groundADCValue)
+{
+	altCalibration_t *calibration = &g_altCalibrations[g_altCalibrationSlot ^ 1];
+
+	g_minAltADCValue = groundADCValue;
+	g_maxAltADCValue = g_minAltADCValue - (ALTITUDE_RANGE_VOLTS * (1 << ADC_WIDTH_BITS)) / ADC_RANGE_VOLTS;
+
+	// Rounded reciprocal of the ADC range, with the rounding half folded into
+	// the offset, so that each conversion is a single multiply-shift
+	uint32_t range = g_minAltADCValue - g_maxAltADCValue;
+	calibration->percentScale = ((100 << ALT_SCALE_SHIFT) + range / 2) / range;
+	calibration->percentOffset = g_minAltADCValue * calibration->percentScale + (1 << (ALT_SCALE_SHIFT - 1));
+	calibration->tenthsScale = ((1000 << ALT_SCALE_SHIFT) + range / 2) / range;
+	calibration->tenthsOffset = g_minAltADCValue * calibration->tenthsScale + (1 << (ALT_SCALE_SHIFT - 1));
+
+	g_altCalibrationSlot ^= 1;
+	g_altRestoredADCValue = 0;
+	g_altCalibrationPending = false;
+
+	programAltitudeLimits();
+}
+
+
+/* *****************************************************************************
+ * checkRestoredCalibration: completes calibration with a restored ground value
+ * if the mean of the most recent samples agrees with it. Otherwise the restored
+ * value is discarded, and calibration waits for a full buffer as usual.
+ */
+static void
+checkRestoredCalibration (void)
+{
+	uint32_t recentSum = 0;
+	uint32_t i;
+
+	for (i = 0; i < ALT_RESTORE_SAMPLES; i++) {
+		recentSum += circBufU16Peek(&g_altitudeBuffer, i);
+	}
+	int32_t error = (int32_t)((recentSum + ALT_RESTORE_SAMPLES / 2) / ALT_RESTORE_SAMPLES) -
+			(int32_t)g_altRestoredADCValue;
+
+	if ((error <= ALT_RESTORE_TOLERANCE) && (error >= -ALT_RESTORE_TOLERANCE)) {
+		completeAltimeterCalibration(g_altRestoredADCValue);
+	} else {
+		g_altRestoredADCValue = 0;
+	}
+}
+
+
+/* *****************************************************************************
+ * updateClimbRate: advances the alpha-beta estimator by one sample. The
+ * estimate is predicted from the previous rate, then both are corrected by a
+ * fraction of the prediction error.
+ */
+static void
+updateClimbRate (uint32_t sample)
+{
+	int32_t measured = (int32_t)(sample << ALT_SCALE_SHIFT);
+
+	if (g_sampleCount == 1) {
+		g_altEstimate = measured;
+		g_altRateEstimate = 0;
+		return;
+	}
+
+	int32_t predicted = g_altEstimate + g_altRateEstimate;
+	int32_t residual = measured - predicted;
+
+	g_altEstimate = predicted + (residual >> ALT_RATE_ALPHA_SHIFT);
+	g_altRateEstimate += residual >> ALT_RATE_BETA_SHIFT;
+}
+
+
+#if ALT_FILTER_MODE == ALT_FILTER_IIR
+/* *****************************************************************************
+ * updateAltitudeIir: passes a sample through the CIC decimator, and each
+ * decimated value through the IIR low-pass. Both stages are primed with the
+ * first sample to avoid a slow rise from zero.
+ */
+static void
+updateAltitudeIir (uint32_t sample)
+{
+	int32_t scaled = (int32_t)(sample << ALT_IIR_FRAC_BITS);
+	int32_t decimated;
+
+	if (g_sampleCount == 1) {
+		initCicDecimator(&g_altitudeCic, ALT_CIC_ORDER, ALT_CIC_DECIMATION_LOG2, scaled);
+		initIirFilter(&g_altitudeIir, ALT_IIR_B0, ALT_IIR_B1, ALT_IIR_B2,
+				ALT_IIR_A1, ALT_IIR_A2, scaled);
+		g_altitudeIirOutput = scaled;
+	}
+	if (cicDecimatorUpdate(&g_altitudeCic, scaled, &decimated)) {
+		g_altitudeIirOutput = iirFilterUpdate(&g_altitudeIir, decimated);
+	}
+}
+#endif
+
+
+/* *****************************************************************************
+ * storeAltitudeSample: adds an ADC value to the circular buffer and the filters
+ * that follow it. Completes a pending calibration once the buffer is full.
+ */
+static void
+storeAltitudeSample (uint32_t sample)
+{
+	uint16_t replaced = writeCircBufU16(&g_altitudeBuffer, sample);
+	circBufStatsUpdate(&g_altitudeStats, sample, replaced);
+#if ALT_FILTER_MODE == ALT_FILTER_MEDIAN
+	medianFilterUpdate(&g_altitudeMedian);
+#endif
+
+	g_sampleCount++;
+	if (g_sampleCount > BUF_SIZE) {
+		g_sampleCount = BUF_SIZE;
+	}
+	updateClimbRate(sample);
+#if ALT_FILTER_MODE == ALT_FILTER_IIR
+	updateAltitudeIir(sample);
+#endif
+
+	if (g_altCalibrationPending && g_altRestoredADCValue && (g_sampleCount >= ALT_RESTORE_SAMPLES)) {
+		checkRestoredCalibration();
+	}
+	if (g_altCalibrationPending && (g_sampleCount == BUF_SIZE)) {
+		completeAltimeterCalibration(circBufU16Mean(&g_altitudeBuffer));
+	}
+}
+
+
+#if ALT_ACQ_MODE == ALT_ACQ_DMA
+/* *****************************************************************************
+ * storeAltitudeBlock: reduces a block of ADC values to its mean, stores it and
+ * re-arms the uDMA transfer into the block.
+ */
+static void
+storeAltitudeBlock (uint32_t channelSelect, uint16_t *block)
+{
+	uint32_t blockSum = 0;
+	uint32_t i;
+
+	for (i = 0; i < ALT_DMA_BLOCK_SIZE; i++) {
+		blockSum += block[i];
+	}
+	uDMAChannelTransferSet(ALT_DMA_CHANNEL | channelSelect, UDMA_MODE_PINGPONG,
+			(void *)(ALTITUDE_ADC_BASE + ADC_O_SSFIFO3), block, ALT_DMA_BLOCK_SIZE);
+
+	storeAltitudeSample((blockSum + ALT_DMA_BLOCK_SIZE / 2) >> ALT_DMA_BLOCK_SIZE_LOG2);
+	g_blockCount++;
+}
+
+
+/* *****************************************************************************
+ * altitudeDMAIntHandler: called when the uDMA has filled the ping or pong
+ * block. Stores the completed block(s), oldest first, and re-arms them while
+ * the other block is being filled. Restarts the channel if it stopped because
+ * both blocks completed.
+ */
+void
+altitudeDMAIntHandler (void)
+{
+	ADCIntClearEx(ALTITUDE_ADC_BASE, ADC_INT_DMA_SS3);
+
+	// Ping is filled on even block counts, pong on odd
+	uint32_t i;
+	for (i = 0; i < 2; i++) {
+		if (g_blockCount & 1) {
+			if (uDMAChannelModeGet(ALT_DMA_CHANNEL | UDMA_ALT_SELECT) != UDMA_MODE_STOP) {
+				break;
+			}
+			storeAltitudeBlock(UDMA_ALT_SELECT, g_pongBlock);
+		} else {
+			if (uDMAChannelModeGet(ALT_DMA_CHANNEL | UDMA_PRI_SELECT) != UDMA_MODE_STOP) {
+				break;
+			}
+			storeAltitudeBlock(UDMA_PRI_SELECT, g_pingBlock);
+		}
+	}
+
+	// If both blocks completed before this ISR ran, the uDMA found neither
+	// armed and disabled the channel; restart it, at ping
+	if (!uDMAChannelIsEnabled(ALT_DMA_CHANNEL)) {
+		uDMAChannelEnable(ALT_DMA_CHANNEL);
+	}
+}
+#endif
+
+
+/* *****************************************************************************
+ * getAltitudeBlockCount: returns the number of sample blocks completed by the
+ * uDMA in ALT_ACQ_DMA mode (0 in other modes). Blocks alternate between the
+ * ping and pong buffers, so an odd count means the last block was ping.
+ */
+uint32_t
+getAltitudeBlockCount (void)
+{
+	return g_blockCount;
+}
+
+
+/* *****************************************************************************
+ * initAltitudeADC: configures the ADC sequencer used for altitude readings, as
+ * selected by ALT_ACQ_MODE, and triggers the first conversion.
+ */
+static void
+initAltitudeADC (void)
+{
+#if ALT_ACQ_MODE == ALT_ACQ_DMA
+	// Conversions triggered by a periodic timer
+	SysCtlPeripheralEnable(ALT_DMA_TIMER_PERIPH);
+	TimerConfigure(ALT_DMA_TIMER_BASE, TIMER_CFG_PERIODIC);
+	TimerLoadSet(ALT_DMA_TIMER_BASE, ALT_DMA_TIMER, SysCtlClockGet() / ALT_DMA_SAMPLE_RATE);
+	TimerControlTrigger(ALT_DMA_TIMER_BASE, ALT_DMA_TIMER, true);
+
+	ADCSequenceConfigure(ALTITUDE_ADC_BASE, ALT_SINGLE_SEQUENCER, ADC_TRIGGER_TIMER, 0);
+	ADCSequenceStepConfigure(ALTITUDE_ADC_BASE, ALT_SINGLE_SEQUENCER, 0,
+			ALTITUDE_ADC_CHANNEL | ADC_CTL_IE | ADC_CTL_END);
+
+	// Results moved alternately into the ping and pong blocks
+	SysCtlPeripheralEnable(SYSCTL_PERIPH_UDMA);
+	uDMAEnable();
+	uDMAControlBaseSet(g_DMAControlTable);
+
+	uDMAChannelAttributeDisable(ALT_DMA_CHANNEL, UDMA_ATTR_ALTSELECT |
+			UDMA_ATTR_USEBURST | UDMA_ATTR_HIGH_PRIORITY | UDMA_ATTR_REQMASK);
+	uDMAChannelControlSet(ALT_DMA_CHANNEL | UDMA_PRI_SELECT,
+			UDMA_SIZE_16 | UDMA_SRC_INC_NONE | UDMA_DST_INC_16 | UDMA_ARB_1);
+	uDMAChannelControlSet(ALT_DMA_CHANNEL | UDMA_ALT_SELECT,
+			UDMA_SIZE_16 | UDMA_SRC_INC_NONE | UDMA_DST_INC_16 | UDMA_ARB_1);
+	uDMAChannelTransferSet(ALT_DMA_CHANNEL | UDMA_PRI_SELECT, UDMA_MODE_PINGPONG,
+			(void *)(ALTITUDE_ADC_BASE + ADC_O_SSFIFO3), g_pingBlock, ALT_DMA_BLOCK_SIZE);
+	uDMAChannelTransferSet(ALT_DMA_CHANNEL | UDMA_ALT_SELECT, UDMA_MODE_PINGPONG,
+			(void *)(ALTITUDE_ADC_BASE + ADC_O_SSFIFO3), g_pongBlock, ALT_DMA_BLOCK_SIZE);
+	uDMAChannelEnable(ALT_DMA_CHANNEL);
+
+	// Interrupt only when a block is complete
+	ADCSequenceDMAEnable(ALTITUDE_ADC_BASE, ALT_SINGLE_SEQUENCER);
+	ADCSequenceEnable(ALTITUDE_ADC_BASE, ALT_SINGLE_SEQUENCER);
+	ADCIntRegister(ALTITUDE_ADC_BASE, ALT_SINGLE_SEQUENCER, altitudeDMAIntHandler);
+	ADCIntClearEx(ALTITUDE_ADC_BASE, ADC_INT_DMA_SS3);
+	ADCIntEnableEx(ALTITUDE_ADC_BASE, ADC_INT_DMA_SS3);
+
+	TimerEnable(ALT_DMA_TIMER_BASE, ALT_DMA_TIMER);
+#elif ALT_ACQ_MODE == ALT_ACQ_OVERSAMPLED
+	uint32_t step;
+
+	ADCHardwareOversampleConfigure(ALTITUDE_ADC_BASE, ALT_HW_OVERSAMPLE);
+	ADCSequenceConfigure(ALTITUDE_ADC_BASE, ALT_BATCH_SEQUENCER, ADC_TRIGGER_PROCESSOR, 0);
+	for (step = 0; step < ALT_BATCH_STEPS - 1; step++) {
+		ADCSequenceStepConfigure(ALTITUDE_ADC_BASE, ALT_BATCH_SEQUENCER, step, ALTITUDE_ADC_CHANNEL);
+	}
+	ADCSequenceStepConfigure(ALTITUDE_ADC_BASE, ALT_BATCH_SEQUENCER, step,
+			ALTITUDE_ADC_CHANNEL | ADC_CTL_IE | ADC_CTL_END);
+
+	ADCSequenceEnable(ALTITUDE_ADC_BASE, ALT_BATCH_SEQUENCER);
+	ADCIntClear(ALTITUDE_ADC_BASE, ALT_BATCH_SEQUENCER);
+	ADCProcessorTrigger(ALTITUDE_ADC_BASE, ALT_BATCH_SEQUENCER); // Get first batch.
+#else
+	ADCSequenceConfigure(ALTITUDE_ADC_BASE, ALT_SINGLE_SEQUENCER, ADC_TRIGGER_PROCESSOR, 0);
+	ADCSequenceStepConfigure(ALTITUDE_ADC_BASE, ALT_SINGLE_SEQUENCER, 0,
+			ALTITUDE_ADC_CHANNEL | ADC_CTL_IE | ADC_CTL_END);
+
+	ADCSequenceEnable(ALTITUDE_ADC_BASE, ALT_SINGLE_SEQUENCER);
+	ADCIntClear(ALTITUDE_ADC_BASE, ALT_SINGLE_SEQUENCER);
+	ADCProcessorTrigger(ALTITUDE_ADC_BASE, ALT_SINGLE_SEQUENCER); // Get first value.
+#endif
+}
+
+
+/* *****************************************************************************
+ * initAltitudeLimits: configures a sequencer to convert continuously into the
+ * digital comparators, with one step and comparator per limit (numbered as in
+ * altitudeLimit_t). Its results go only to the comparators, so the sequencer
+ * never interrupts or fills its FIFO.
+ */
+static void
+initAltitudeLimits (void)
+{
+	uint32_t i;
+
+	ADCSequenceConfigure(ALTITUDE_ADC_BASE, ALT_LIMIT_SEQUENCER, ADC_TRIGGER_ALWAYS, 3);
+	for (i = 0; i < NUM_ALT_LIMITS; i++) {
+		ADCComparatorConfigure(ALTITUDE_ADC_BASE, i, ADC_COMP_INT_NONE);
+	}
+	ADCSequenceStepConfigure(ALTITUDE_ADC_BASE, ALT_LIMIT_SEQUENCER, ALT_LIMIT_GROUND,
+			ALTITUDE_ADC_CHANNEL | ADC_CTL_CMP0);
+	ADCSequenceStepConfigure(ALTITUDE_ADC_BASE, ALT_LIMIT_SEQUENCER, ALT_LIMIT_CEILING,
+			ALTITUDE_ADC_CHANNEL | ADC_CTL_CMP1 | ADC_CTL_END);
+
+	ADCIntRegister(ALTITUDE_ADC_BASE, ALT_LIMIT_SEQUENCER, altitudeLimitIntHandler);
+	ADCComparatorIntClear(ALTITUDE_ADC_BASE, 0xFF);
+	ADCComparatorIntEnable(ALTITUDE_ADC_BASE, ALT_LIMIT_SEQUENCER);
+	ADCSequenceEnable(ALTITUDE_ADC_BASE, ALT_LIMIT_SEQUENCER);
 }
 
 
 /* *****************************************************************************
  * updateAltitude: reads an ADC value (where available), stores it in a circular
- * buffer, and triggers the next ADC conversion.
+ * buffer, and triggers the next ADC conversion. In ALT_ACQ_OVERSAMPLED mode the
+ * value is the mean of a batch of hardware-averaged conversions. In ALT_ACQ_DMA
+ * mode this does nothing, as blocks are stored by the ADC interrupt.
  * NOTE: a single ADC conversion must be triggered externally for this function
  * to operate.
  */
 void
 updateAltitude (void)
 {
-	if (ADCIntStatus(ALTITUDE_ADC_BASE, 3, false)) { // ADC has value ready
-		ADCIntClear(ALTITUDE_ADC_BASE, 3);
+	uint32_t sample;
 
-		uint32_t ADCSampleBuffer[1];
-		ADCSequenceDataGet(ALTITUDE_ADC_BASE, 3, ADCSampleBuffer);
+	if (readAltitudeADC(&sample)) { // ADC has value ready
+		storeAltitudeSample(sample);
+	}
+}
 
-		writeCircBuf(&g_altitudeBuffer, ADCSampleBuffer[0]);
 
-		g_sampleCount++;
-		if (g_sampleCount > BUF_SIZE) {
-			g_sampleCount = BUF_SIZE;
-		}
+/* *****************************************************************************
+ * setAltitudeLimits: sets the altitudes (as percentages) below which the
+ * ALT_LIMIT_GROUND limit, and above which the ALT_LIMIT_CEILING limit, is
+ * active. The limits are watched by the ADC digital comparators, so crossings
+ * are detected by interrupt without polling. Thresholds follow recalibration.
+ */
+void
+setAltitudeLimits (uint16_t groundPercent, uint16_t ceilingPercent)
+{
+	// Calibration completes in an ISR, which also programs the limits
+	bool wasDisabled = IntMasterDisable();
 
-		ADCProcessorTrigger(ALTITUDE_ADC_BASE, 3);
+	g_altLimitPercent[ALT_LIMIT_GROUND] = groundPercent;
+	g_altLimitPercent[ALT_LIMIT_CEILING] = ceilingPercent;
+	programAltitudeLimits();
+
+	if (!wasDisabled) {
+		IntMasterEnable();
 	}
 }
 
 
 /* *****************************************************************************
- * calibrateAltimeter: waits for sufficient ADC samples to be taken for the
- * circular buffer to be filled. After the buffer is filled, the global minimum
- * and maximum ADC values are (re)calculated.
- * NOTE: waiting method is blocking.
+ * altitudeLimitActive_p: returns true if the altitude is currently beyond the
+ * given limit.
+ */
+bool
+altitudeLimitActive_p (altitudeLimit_t limit)
+{
+	return g_altLimitActive[limit];
+}
+
+
+/* *****************************************************************************
+ * checkAltitudeEvent: returns true if the given limit has been crossed into
+ * since the last call, otherwise false.
+ */
+bool
+checkAltitudeEvent (altitudeLimit_t limit)
+{
+	bool event = g_altLimitEvent[limit];
+
+	if (event) {
+		g_altLimitEvent[limit] = false;
+	}
+	return event;
+}
+
+
+/* *****************************************************************************
+ * clearAltitudeEvents: discards the events of every limit, so that
+ * checkAltitudeEvent only reports crossings from now on.
  */
 void
-calibrateAltimeter (void)
+clearAltitudeEvents (void)
 {
-    while (g_sampleCount < BUF_SIZE) {
-        updateAltitude(); // Wait for buffer to be filled, for calibration
-        SysCtlDelay(SysCtlClockGet() / (3 * ALT_INIT_POLL_RATE));
-    }
+	uint32_t i;
 
-    g_minAltADCValue = circBufMean(&g_altitudeBuffer);
-    g_maxAltADCValue = g_minAltADCValue - (ALTITUDE_RANGE_VOLTS * (1 << ADC_WIDTH_BITS)) / ADC_RANGE_VOLTS;
+	for (i = 0; i < NUM_ALT_LIMITS; i++) {
+		g_altLimitEvent[i] = false;
+	}
 }
 
 
 /* *****************************************************************************
- * initAltimeter: initialises the pin required for altitude readings and the
- * buffer in which read values are stored. Calibrates readings.
+ * startAltimeterCalibration: requests that the ground altitude be
+ * (re)calculated. Calibration completes in the background once the circular
+ * buffer holds a full window of samples, which is immediate if it already
+ * does. Until then, altitudes are based on the previous calibration (0 before
+ * the first).
+ */
+void
+startAltimeterCalibration (void)
+{
+	g_altRestoredADCValue = 0;
+	g_altCalibrationPending = true;
+}
+
+
+/* *****************************************************************************
+ * restoreAltimeterCalibration: as for startAltimeterCalibration, but offers a
+ * previously saved ground ADC value. It is used as soon as ALT_RESTORE_SAMPLES
+ * samples confirm it (within ALT_RESTORE_TOLERANCE), rather than waiting for a
+ * full buffer.
+ */
+void
+restoreAltimeterCalibration (uint16_t groundADCValue)
+{
+	g_altRestoredADCValue = groundADCValue;
+	g_altCalibrationPending = true;
+}
+
+
+/* *****************************************************************************
+ * getAltimeterGroundADCValue: returns the ground ADC value of the current
+ * calibration (0 before the first), e.g. to be saved for a later restart.
+ */
+uint16_t
+getAltimeterGroundADCValue (void)
+{
+	return g_minAltADCValue;
+}
+
+
+/* *****************************************************************************
+ * altimeterCalibrated_p: returns true if no calibration is pending.
+ */
+bool
+altimeterCalibrated_p (void)
+{
+	return !g_altCalibrationPending;
+}
+
+
+/* *****************************************************************************
+ * getAltimeterCalibrationProgress: returns the progress of a pending
+ * calibration as a percentage, or 100 if none is pending.
+ */
+uint8_t
+getAltimeterCalibrationProgress (void)
+{
+	if (!g_altCalibrationPending) {
+		return 100;
+	}
+	return (g_sampleCount * 100) / BUF_SIZE;
+}
+
+
+/* *****************************************************************************
+ * initAltimeter: initialises the pin required for altitude readings, the
+ * limit comparators and the buffer in which read values are stored. Starts
+ * calibration, which completes once the polling (or DMA) interrupt has filled
+ * the buffer.
  */
 void
 initAltimeter (void)
@@ -109,15 +795,14 @@ initAltimeter (void)
 	SysCtlPeripheralEnable(ALTITUDE_PIN_PERIPH);
 
 	GPIOPinTypeADC(ALTITUDE_PIN_BASE, ALTITUDE_PIN);
-	ADCSequenceConfigure(ALTITUDE_ADC_BASE, 3, ADC_TRIGGER_PROCESSOR, 0);
-	ADCSequenceStepConfigure(ALTITUDE_ADC_BASE, 3, 0, ADC_CTL_CH9 | ADC_CTL_IE | ADC_CTL_END);
-
-	ADCSequenceEnable(ALTITUDE_ADC_BASE, 3);
-	ADCIntClear(ALTITUDE_ADC_BASE, 3);
-
-	ADCProcessorTrigger(ALTITUDE_ADC_BASE, 3); // Get first value.
+	initAltitudeADC();
+	initAltitudeLimits();
 
-	initCircBuf(&g_altitudeBuffer, BUF_SIZE);
+	initCircBufU16(&g_altitudeBuffer);
+	initCircBufStats(&g_altitudeStats);
+#if ALT_FILTER_MODE == ALT_FILTER_MEDIAN
+	initMedianFilter(&g_altitudeMedian, &g_altitudeBuffer);
+#endif
 	g_sampleCount = 0;
-	calibrateAltimeter();
+	startAltimeterCalibration();
 }
@@ -13,6 +13,9 @@
  */
 
 #include <stdint.h>
+#include <stdbool.h>
+#include "circBufStatic.h"
+#include "decimatingFilter.h"
 
 /* *****************************************************************************
  * Altitude peripheral definition
@@ -23,6 +26,7 @@
 
 #define ALTITUDE_ADC_BASE ADC0_BASE
 #define ALTITUDE_ADC_PERIPH SYSCTL_PERIPH_ADC0
+#define ALTITUDE_ADC_CHANNEL ADC_CTL_CH9
 #define ALTITUDE_RANGE_VOLTS 0.8
 #define ADC_WIDTH_BITS 12
 #define ADC_RANGE_VOLTS 3.3
@@ -30,8 +34,69 @@
 /* *****************************************************************************
  * General
  */
-#define BUF_SIZE 25 // size of the circular buffer for altitude ADC values
-#define ALT_INIT_POLL_RATE 200 // Rate at which initial altitude samples are taken for initialization
+#define BUF_SIZE_LOG2 5 // log2 of the size of the circular buffer for altitude ADC values
+#define BUF_SIZE (1 << BUF_SIZE_LOG2)
+#define ALT_SCALE_SHIFT 16 // fractional bits of the ADC-to-altitude scales
+#define ALT_RESTORE_SAMPLES 4 // samples averaged to confirm a restored calibration
+#define ALT_RESTORE_TOLERANCE 40 // ADC counts (about 4%) a restored ground value may be off by
+
+// Filter applied to the buffer of altitude ADC values
+#define ALT_FILTER_MEAN 0 // boxcar mean
+#define ALT_FILTER_MEDIAN 1 // sliding median, rejects spikes
+#define ALT_FILTER_IIR 2 // CIC decimator then IIR low-pass, independent of BUF_SIZE
+#ifndef ALT_FILTER_MODE
+#define ALT_FILTER_MODE ALT_FILTER_MEAN
+#endif
+
+// Acquisition of altitude ADC values
+#define ALT_ACQ_SINGLE 0 // one software-triggered conversion on sequencer 3 per poll
+#define ALT_ACQ_OVERSAMPLED 1 // hardware-averaged batch from the sequencer 0 FIFO per poll
+#define ALT_ACQ_DMA 2 // timer-triggered conversions on sequencer 3, moved in blocks by uDMA
+#ifndef ALT_ACQ_MODE
+#define ALT_ACQ_MODE ALT_ACQ_SINGLE
+#endif
+
+#define ALT_SINGLE_SEQUENCER 3
+#define ALT_BATCH_SEQUENCER 0
+#define ALT_BATCH_STEPS_LOG2 3 // sequencer 0 has 8 steps
+#define ALT_BATCH_STEPS (1 << ALT_BATCH_STEPS_LOG2)
+#define ALT_HW_OVERSAMPLE 16 // conversions averaged by the ADC per step, power of 2 up to 64
+
+// Timer-triggered uDMA acquisition
+#define ALT_DMA_SAMPLE_RATE 3200 // conversions per second
+#define ALT_DMA_BLOCK_SIZE_LOG2 4 // each block is reduced to a single buffer entry
+#define ALT_DMA_BLOCK_SIZE (1 << ALT_DMA_BLOCK_SIZE_LOG2)
+#define ALT_DMA_CHANNEL UDMA_CHANNEL_ADC3
+#define ALT_DMA_TIMER_PERIPH SYSCTL_PERIPH_TIMER1
+#define ALT_DMA_TIMER_BASE TIMER1_BASE
+#define ALT_DMA_TIMER TIMER_A
+
+// Alpha-beta climb rate estimator, updated with each stored sample
+#if ALT_ACQ_MODE == ALT_ACQ_DMA
+#define ALT_SAMPLE_RATE (ALT_DMA_SAMPLE_RATE >> ALT_DMA_BLOCK_SIZE_LOG2)
+#else
+#define ALT_SAMPLE_RATE 200 // must match the rate at which updateAltitude is polled
+#endif
+#define ALT_RATE_ALPHA_SHIFT 3 // alpha = 1/8
+#define ALT_RATE_BETA_SHIFT 6 // beta = 1/64
+
+// CIC decimator and IIR low-pass pipeline (ALT_FILTER_IIR)
+#define ALT_CIC_ORDER 3
+#define ALT_CIC_DECIMATION_LOG2 1 // 200 Hz samples decimated to the 100 Hz control rate
+#define ALT_IIR_FRAC_BITS 4 // extra fractional bits of ADC counts carried through the pipeline
+
+// Second order Butterworth low-pass, 10 Hz cutoff at the 100 Hz decimated rate
+#define ALT_IIR_B0 IIR_COEFF(0.0674553)
+#define ALT_IIR_B1 IIR_COEFF(0.1349105)
+#define ALT_IIR_B2 IIR_COEFF(0.0674553)
+#define ALT_IIR_A1 IIR_COEFF(-1.1429805)
+#define ALT_IIR_A2 IIR_COEFF(0.4128016)
+
+// Altitude limits, monitored by the ADC digital comparators
+#define ALT_LIMIT_SEQUENCER 2 // continuously converts, at the lowest priority
+#define ALT_LIMIT_HYSTERESIS 8 // ADC counts a limit must be re-crossed by before it clears
+
+typedef enum altitudeLimit {ALT_LIMIT_GROUND = 0, ALT_LIMIT_CEILING, NUM_ALT_LIMITS} altitudeLimit_t;
 
 // Macros
 #define MIN(a,b) a>b?b:a
@@ -39,17 +104,101 @@
 
 /* *****************************************************************************
  * getCurrentAltitude: calculates and returns the current altitude based on the
- * average of the circular buffer. The returned value is a percentage based on
- * the expected input voltage range - 0% representing the lowest altitude, 100%
- * the highest. Returned value may exceed 100 (the result of equipment
- * variation).
+ * filtered altitude ADC values (see ALT_FILTER_MODE). The returned value is a
+ * percentage based on the expected input voltage range - 0% representing the
+ * lowest altitude, 100% the highest. Returned value may exceed 100 (the result
+ * of equipment variation).
  */
 uint16_t
 getCurrentAltitude (void);
 
+/* *****************************************************************************
+ * getCurrentAltitudeTenths: as for getCurrentAltitude, but in tenths of a
+ * percent (1000 representing the highest altitude).
+ */
+int32_t
+getCurrentAltitudeTenths (void);
+
+/* *****************************************************************************
+ * getAltitudeClimbRate: returns the rate of climb in tenths of a percent per
+ * second, as estimated by an alpha-beta filter over the raw samples. It lags a
+ * slow change by about alpha / beta (8) samples, where differencing
+ * getCurrentAltitude lags by half the filter window.
+ */
+int32_t
+getAltitudeClimbRate (void);
+
+/* *****************************************************************************
+ * getAltitudeADCMin: returns the smallest ADC value in the altitude window.
+ * Note that a higher altitude gives a lower ADC value.
+ */
+uint16_t
+getAltitudeADCMin (void);
+
+/* *****************************************************************************
+ * getAltitudeADCMax: returns the largest ADC value in the altitude window.
+ */
+uint16_t
+getAltitudeADCMax (void);
+
+/* *****************************************************************************
+ * getAltitudeNoise: returns the variance of the ADC values in the altitude
+ * window, in ADC counts squared. May be used to detect sensor faults.
+ */
+uint32_t
+getAltitudeNoise (void);
+
+/* *****************************************************************************
+ * openAltitudeStream: attaches reader to the buffer of raw altitude ADC
+ * samples, so that consumers such as loggers can follow the samples at their
+ * own rate without copying them. Samples are read with readCircBufU16Reader.
+ */
+void
+openAltitudeStream (circBufU16Reader_t *reader, circBufOverrunPolicy_t policy);
+
+/* *****************************************************************************
+ * setAltitudeLimits: sets the altitudes (as percentages) below which the
+ * ALT_LIMIT_GROUND limit, and above which the ALT_LIMIT_CEILING limit, is
+ * active. The limits are watched by the ADC digital comparators, so crossings
+ * are detected by interrupt without polling. Thresholds follow recalibration.
+ */
+void
+setAltitudeLimits (uint16_t groundPercent, uint16_t ceilingPercent);
+
+/* *****************************************************************************
+ * altitudeLimitActive_p: returns true if the altitude is currently beyond the
+ * given limit.
+ */
+bool
+altitudeLimitActive_p (altitudeLimit_t limit);
+
+/* *****************************************************************************
+ * checkAltitudeEvent: returns true if the given limit has been crossed into
+ * since the last call, otherwise false.
+ */
+bool
+checkAltitudeEvent (altitudeLimit_t limit);
+
+/* *****************************************************************************
+ * clearAltitudeEvents: discards the events of every limit, so that
+ * checkAltitudeEvent only reports crossings from now on.
+ */
+void
+clearAltitudeEvents (void);
+
+/* *****************************************************************************
+ * getAltitudeBlockCount: returns the number of sample blocks completed by the
+ * uDMA in ALT_ACQ_DMA mode (0 in other modes). Blocks alternate between the
+ * ping and pong buffers, so an odd count means the last block was ping.
+ */
+uint32_t
+getAltitudeBlockCount (void);
+
 /* *****************************************************************************
  * updateAltitude: reads an ADC value (where available), stores it in a circular
- * buffer, and triggers the next ADC conversion.
+ * buffer, and triggers the next ADC conversion. In ALT_ACQ_OVERSAMPLED mode the
+ * value is the mean of a batch of hardware-averaged conversions. In ALT_ACQ_DMA
+ * mode this does nothing, as blocks are stored by the ADC interrupt.
  * NOTE: a single ADC conversion must be triggered externally for this function
  * to operate.
  */
@@ -57,17 +206,49 @@ void
 updateAltitude (void);
 
 /* *****************************************************************************
- * calibrateAltimeter: waits for sufficient ADC samples to be taken for the
- * circular buffer to be filled. After the buffer is filled, the global minimum
- * and maximum ADC values are (re)calculated.
- * NOTE: waiting method is blocking.
+ * startAltimeterCalibration: requests that the ground altitude be
+ * (re)calculated. Calibration completes in the background once the circular
+ * buffer holds a full window of samples, which is immediate if it already
+ * does. Until then, altitudes are based on the previous calibration (0 before
+ * the first).
+ */
+void
+startAltimeterCalibration (void);
+
+/* *****************************************************************************
+ * restoreAltimeterCalibration: as for startAltimeterCalibration, but offers a
+ * previously saved ground ADC value. It is used as soon as ALT_RESTORE_SAMPLES
+ * samples confirm it (within ALT_RESTORE_TOLERANCE), rather than waiting for a
+ * full buffer.
  */
 void
-calibrateAltimeter (void);
+restoreAltimeterCalibration (uint16_t groundADCValue);
+
+/* *****************************************************************************
+ * getAltimeterGroundADCValue: returns the ground ADC value of the current
+ * calibration (0 before the first), e.g. to be saved for a later restart.
+ */
+uint16_t
+getAltimeterGroundADCValue (void);
+
+/* *****************************************************************************
+ * altimeterCalibrated_p: returns true if no calibration is pending.
+ */
+bool
+altimeterCalibrated_p (void);
+
+/* *****************************************************************************
+ * getAltimeterCalibrationProgress: returns the progress of a pending
+ * calibration as a percentage, or 100 if none is pending.
+ */
+uint8_t
+getAltimeterCalibrationProgress (void);
 
 /* *****************************************************************************
- * initAltimeter: initialises the pin required for altitude readings and the
- * buffer in which read values are stored. Calibrates readings.
+ * initAltimeter: initialises the pin required for altitude readings, the
+ * limit comparators and the buffer in which read values are stored. Starts
+ * calibration, which completes once the polling (or DMA) interrupt has filled
+ * the buffer.
  */
 void
 initAltimeter (void);
@@ -0,0 +1,69 @@
+/* *****************************************************************************
+ * calibrationStore.c
+ *
+ * Persists calibration results in non-volatile storage, as a versioned and
+ * CRC-checked record.
+ *
+ * Hangwen Hu and Marc Katzef
+ * Last modified:  16.10.2026
+ */
+
+#include "calibrationStore.h"
+#include "nvStorage.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define CRC32_POLYNOMIAL 0xEDB88320 // reflected IEEE 802.3
+#define CALIBRATION_CRC_WORDS ((sizeof(calibrationRecord_t) - sizeof(uint32_t)) / sizeof(uint32_t))
+
+/* *****************************************************************************
+ * calibrationCrc: returns the CRC-32 of the record, excluding the crc field.
+ * Computed bitwise, as the record is only a few words long.
+ */
+static uint32_t
+calibrationCrc (const calibrationRecord_t *record)
+{
+	const uint32_t *words = (const uint32_t *)record;
+	uint32_t crc = 0xFFFFFFFF;
+	uint32_t i;
+	uint32_t bit;
+
+	for (i = 0; i < CALIBRATION_CRC_WORDS; i++) {
+		crc ^= words[i];
+		for (bit = 0; bit < 32; bit++) {
+			crc = (crc >> 1) ^ (CRC32_POLYNOMIAL & -(crc & 1));
+		}
+	}
+	return ~crc;
+}
+
+
+/* *****************************************************************************
+ * loadCalibration: reads the stored record into *record. Returns true only if
+ * it has the expected magic number, version and CRC.
+ */
+bool
+loadCalibration (calibrationRecord_t *record)
+{
+	if (!readNvStorage(NV_CALIBRATION_ADDRESS, (uint32_t *)record, sizeof(*record))) {
+		return false;
+	}
+	return (record->magic == CALIBRATION_MAGIC) &&
+			(record->version == CALIBRATION_VERSION) &&
+			(record->crc == calibrationCrc(record));
+}
+
+
+/* *****************************************************************************
+ * saveCalibration: sets the magic number, version and CRC of *record and
+ * writes it to storage. Blocks until complete. Returns false on failure.
+ */
+bool
+saveCalibration (calibrationRecord_t *record)
+{
+	record->magic = CALIBRATION_MAGIC;
+	record->version = CALIBRATION_VERSION;
+	record->crc = calibrationCrc(record);
+	return writeNvStorage(NV_CALIBRATION_ADDRESS, (const uint32_t *)record, sizeof(*record));
+}
@@ -0,0 +1,51 @@
+#ifndef CALIBRATIONSTORE_H_
+#define CALIBRATIONSTORE_H_
+
+/* *****************************************************************************
+ * calibrationStore.h
+ *
+ * Persists calibration results in non-volatile storage, so that a restart can
+ * reuse them rather than recalibrating from scratch.
+ *
+ * The record is tagged with a magic number and layout version, and protected
+ * by a CRC-32, so a blank, stale or partially written record is rejected.
+ *
+ * Hangwen Hu and Marc Katzef
+ * Last modified:  16.10.2026
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* *****************************************************************************
+ * Record definition
+ */
+#define CALIBRATION_MAGIC 0x48454C49 // "HELI"
+#define CALIBRATION_VERSION 1 // increment whenever the record layout changes
+
+// Flags
+#define CALIBRATION_YAW_AT_REF 0x1 // landed with the yaw count zeroed at the reference
+
+typedef struct {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t altGroundADCValue;	// altitude ADC value at 0%
+	uint32_t flags;
+	uint32_t crc;				// CRC-32 of the preceding fields
+} calibrationRecord_t;
+
+/* *****************************************************************************
+ * loadCalibration: reads the stored record into *record. Returns true only if
+ * it has the expected magic number, version and CRC.
+ */
+bool
+loadCalibration (calibrationRecord_t *record);
+
+/* *****************************************************************************
+ * saveCalibration: sets the magic number, version and CRC of *record and
+ * writes it to storage. Blocks until complete. Returns false on failure.
+ */
+bool
+saveCalibration (calibrationRecord_t *record);
+
+#endif /* CALIBRATIONSTORE_H_ */
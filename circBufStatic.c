@@ -0,0 +1,274 @@
+/* *****************************************************************************
+ * circBufStatic.c
+ *
+ * Support for statically allocated, typed circular buffers on the Tiva
+ * processor. The number of entries is a power of two fixed at compile time, so
+ * indices wrap with a bitmask and no heap is required.
+ *
+ * Hangwen Hu and Marc Katzef
+ * Last modified:  16.10.2026
+ */
+
+#include "circBufStatic.h"
+#include "circBufT.h"
+
+#include <stdint.h>
+#include <string.h>
+
+/* *****************************************************************************
+ * Number of writes completed or started, from a buffer's writeSeq
+ */
+#define CIRCBUF_WRITES_COMPLETED(writeSeq) ((writeSeq) >> 1)
+#define CIRCBUF_WRITES_STARTED(writeSeq) (((writeSeq) + 1) >> 1)
+
+/* *****************************************************************************
+ * Empties a buffer and clears its data array. The write count advances by a
+ * full window rather than restarting at zero, as if the cleared entries had
+ * been written, so that attached readers and snapshots in progress see every
+ * earlier entry as overwritten. Readers skip to initCount (see
+ * readCircBuf<tag>Reader).
+ */
+#define CIRCBUF_STATIC_RESET(tag, buffer) \
+	do { \
+		uint32_t writeSeq = (buffer)->writeSeq + 2 * ((buffer)->mask + 1); \
+		\
+		CIRCBUF_SHARED((buffer)->writeSeq) = writeSeq - 1; /* Odd: writing */ \
+		CIRCBUF_MEMORY_BARRIER(); \
+		CIRCBUF_SHARED((buffer)->initCount) = CIRCBUF_WRITES_COMPLETED(writeSeq); \
+		memset((buffer)->data, 0, ((buffer)->mask + 1) * sizeof(circBuf##tag##Entry_t)); \
+		(buffer)->rindex = (buffer)->windex; /* windex is unchanged by a full window */ \
+		CIRCBUF_MEMORY_BARRIER(); \
+		CIRCBUF_SHARED((buffer)->writeSeq) = writeSeq; /* Even: done */ \
+	} while (0)
+
+/* *****************************************************************************
+ * Function definitions shared by all buffer types. See circBufStatic.h for
+ * descriptions.
+ */
+#define CIRCBUF_STATIC_READ_IMPL(tag) \
+	circBuf##tag##Entry_t \
+	readCircBuf##tag (circBuf##tag##_t *buffer) \
+	{ \
+		uint32_t rindex = buffer->rindex; \
+		buffer->rindex = (rindex + 1) & buffer->mask; \
+		return buffer->data[rindex]; \
+	} \
+	\
+	circBuf##tag##Entry_t \
+	circBuf##tag##Peek (circBuf##tag##_t *buffer, uint32_t age) \
+	{ \
+		uint32_t index = (CIRCBUF_SHARED(buffer->windex) - 1 - age) & buffer->mask; \
+		return ((volatile circBuf##tag##Entry_t *)buffer->data)[index]; \
+	} \
+	\
+	void \
+	circBuf##tag##View (circBuf##tag##_t *buffer, circBuf##tag##View_t *view) \
+	{ \
+		uint32_t windex = CIRCBUF_SHARED(buffer->windex); \
+		view->first = &buffer->data[windex]; \
+		view->firstLength = buffer->mask + 1 - windex; \
+		view->second = buffer->data; \
+		view->secondLength = windex; \
+	} \
+	\
+	uint32_t \
+	circBuf##tag##Snapshot (circBuf##tag##_t *buffer, circBuf##tag##Entry_t *dest, \
+			uint32_t count) \
+	{ \
+		uint32_t size = buffer->mask + 1; \
+		uint32_t seqStart; \
+		uint32_t writes; \
+		uint32_t index; \
+		uint32_t i; \
+		\
+		if (count > size) \
+			count = size; \
+		\
+		do { \
+			do { \
+				seqStart = CIRCBUF_SHARED(buffer->writeSeq); \
+			} while (seqStart & 1); /* Wait for a write in progress to finish */ \
+			CIRCBUF_MEMORY_BARRIER(); \
+			\
+			index = CIRCBUF_SHARED(buffer->windex) - count; \
+			for (i = 0; i < count; i++) { \
+				dest[i] = ((volatile circBuf##tag##Entry_t *)buffer->data)[index & buffer->mask]; \
+				index++; \
+			} \
+			\
+			/* Writes replace the oldest entries first, so the copy is only */ \
+			/* invalid if more than (size - count) writes started meanwhile */ \
+			CIRCBUF_MEMORY_BARRIER(); \
+			writes = (CIRCBUF_SHARED(buffer->writeSeq) - seqStart + 1) / 2; \
+		} while (writes > size - count); \
+		\
+		return count; \
+	} \
+	\
+	void \
+	initCircBuf##tag##Reader (circBuf##tag##Reader_t *reader, circBuf##tag##_t *buffer, \
+			circBufOverrunPolicy_t policy) \
+	{ \
+		reader->buffer = buffer; \
+		reader->readCount = CIRCBUF_WRITES_STARTED(CIRCBUF_SHARED(buffer->writeSeq)); \
+		reader->drops = 0; \
+		reader->policy = policy; \
+	} \
+	\
+	circBufStatus_t \
+	readCircBuf##tag##Reader (circBuf##tag##Reader_t *reader, circBuf##tag##Entry_t *entry) \
+	{ \
+		circBuf##tag##_t *buffer = reader->buffer; \
+		uint32_t size = buffer->mask + 1; \
+		uint32_t readCount = reader->readCount; \
+		uint32_t writeCount; \
+		uint32_t initCount; \
+		\
+		while (1) { \
+			writeCount = CIRCBUF_WRITES_COMPLETED(CIRCBUF_SHARED(buffer->writeSeq)); \
+			CIRCBUF_MEMORY_BARRIER(); \
+			initCount = CIRCBUF_SHARED(buffer->initCount); \
+			if ((int32_t)(initCount - readCount) > 0) { /* Buffer initialised since */ \
+				reader->drops += initCount - size - readCount; \
+				readCount = initCount; \
+			} \
+			if ((int32_t)(writeCount - readCount) <= 0) { \
+				reader->readCount = readCount; \
+				return CIRCBUF_EMPTY; \
+			} \
+			\
+			if (writeCount - readCount > size) { /* Lapped by the writer */ \
+				uint32_t skipTo = (reader->policy == CIRCBUF_SKIP_TO_NEWEST) ? \
+						writeCount - 1 : writeCount - size; \
+				reader->drops += skipTo - readCount; \
+				readCount = skipTo; \
+			} \
+			\
+			CIRCBUF_MEMORY_BARRIER(); \
+			*entry = ((volatile circBuf##tag##Entry_t *)buffer->data)[readCount & buffer->mask]; \
+			CIRCBUF_MEMORY_BARRIER(); \
+			\
+			/* The entry is valid unless its slot was rewritten during the copy */ \
+			if (CIRCBUF_WRITES_STARTED(CIRCBUF_SHARED(buffer->writeSeq)) - readCount <= size) { \
+				reader->readCount = readCount + 1; \
+				return CIRCBUF_OK; \
+			} \
+		} \
+	} \
+	\
+	uint32_t \
+	circBuf##tag##ReaderLag (circBuf##tag##Reader_t *reader) \
+	{ \
+		circBuf##tag##_t *buffer = reader->buffer; \
+		uint32_t writeCount = CIRCBUF_WRITES_COMPLETED(CIRCBUF_SHARED(buffer->writeSeq)); \
+		uint32_t readCount = reader->readCount; \
+		\
+		if ((int32_t)(CIRCBUF_SHARED(buffer->initCount) - readCount) > 0) { \
+			readCount += buffer->mask + 1; /* The cleared window holds no entries */ \
+		} \
+		return writeCount - readCount; \
+	}
+
+#define CIRCBUF_STATIC_IMPL(tag) \
+	void \
+	initCircBuf##tag (circBuf##tag##_t *buffer) \
+	{ \
+		CIRCBUF_STATIC_RESET(tag, buffer); \
+	} \
+	\
+	circBuf##tag##Entry_t \
+	writeCircBuf##tag (circBuf##tag##_t *buffer, circBuf##tag##Entry_t entry) \
+	{ \
+		uint32_t windex = buffer->windex; \
+		circBuf##tag##Entry_t replaced = buffer->data[windex]; \
+		\
+		CIRCBUF_SHARED(buffer->writeSeq) = buffer->writeSeq + 1; /* Odd: writing */ \
+		CIRCBUF_MEMORY_BARRIER(); \
+		((volatile circBuf##tag##Entry_t *)buffer->data)[windex] = entry; \
+		CIRCBUF_SHARED(buffer->windex) = (windex + 1) & buffer->mask; \
+		CIRCBUF_MEMORY_BARRIER(); \
+		CIRCBUF_SHARED(buffer->writeSeq) = buffer->writeSeq + 1; /* Even: done */ \
+		return replaced; \
+	} \
+	\
+	CIRCBUF_STATIC_READ_IMPL(tag)
+
+/* *****************************************************************************
+ * As CIRCBUF_STATIC_IMPL, maintaining the running sum. If resumOnWrap is
+ * non-zero the sum is recalculated from the data array each time windex wraps,
+ * which bounds the rounding drift of floating point sums.
+ */
+#define CIRCBUF_STATIC_SUM_IMPL(tag, resumOnWrap) \
+	void \
+	initCircBuf##tag (circBuf##tag##_t *buffer) \
+	{ \
+		CIRCBUF_STATIC_RESET(tag, buffer); \
+		buffer->sum = 0; \
+	} \
+	\
+	circBuf##tag##Entry_t \
+	writeCircBuf##tag (circBuf##tag##_t *buffer, circBuf##tag##Entry_t entry) \
+	{ \
+		uint32_t windex = buffer->windex; \
+		circBuf##tag##Entry_t replaced = buffer->data[windex]; \
+		\
+		CIRCBUF_SHARED(buffer->writeSeq) = buffer->writeSeq + 1; /* Odd: writing */ \
+		CIRCBUF_MEMORY_BARRIER(); \
+		buffer->sum += entry - replaced; \
+		((volatile circBuf##tag##Entry_t *)buffer->data)[windex] = entry; \
+		windex = (windex + 1) & buffer->mask; \
+		CIRCBUF_SHARED(buffer->windex) = windex; \
+		CIRCBUF_MEMORY_BARRIER(); \
+		CIRCBUF_SHARED(buffer->writeSeq) = buffer->writeSeq + 1; /* Even: done */ \
+		\
+		if ((resumOnWrap) && windex == 0) { \
+			uint32_t i; \
+			buffer->sum = 0; \
+			for (i = 0; i <= buffer->mask; i++) { \
+				buffer->sum += buffer->data[i]; \
+			} \
+		} \
+		return replaced; \
+	} \
+	\
+	CIRCBUF_STATIC_READ_IMPL(tag)
+
+CIRCBUF_STATIC_SUM_IMPL(U32, 0)
+CIRCBUF_STATIC_SUM_IMPL(U16, 0)
+CIRCBUF_STATIC_SUM_IMPL(F32, 1)
+CIRCBUF_STATIC_IMPL(Timed)
+
+
+/* *****************************************************************************
+ * circBufU32Mean: returns the rounded mean of the buffer entries.
+ * NOTE: the sum of all entries must fit in 32 bits.
+ */
+uint32_t
+circBufU32Mean (circBufU32_t *buffer)
+{
+    uint32_t bufferSize = buffer->mask + 1;
+
+    return (buffer->sum + bufferSize / 2) >> buffer->sizeLog2;
+}
+
+
+/* *****************************************************************************
+ * circBufU16Mean: returns the rounded mean of the buffer entries.
+ */
+uint16_t
+circBufU16Mean (circBufU16_t *buffer)
+{
+    uint32_t bufferSize = buffer->mask + 1;
+
+    return (buffer->sum + bufferSize / 2) >> buffer->sizeLog2;
+}
+
+
+/* *****************************************************************************
+ * circBufF32Mean: returns the mean of the buffer entries.
+ */
+float
+circBufF32Mean (circBufF32_t *buffer)
+{
+    return buffer->sum / (1u << buffer->sizeLog2);
+}
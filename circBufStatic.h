@@ -0,0 +1,154 @@
+#ifndef CIRCBUFSTATIC_H_
+#define CIRCBUFSTATIC_H_
+
+/* *****************************************************************************
+ * circBufStatic.h
+ *
+ * Support for statically allocated, typed circular buffers on the Tiva
+ * processor. The number of entries is a power of two fixed at compile time, so
+ * indices wrap with a bitmask and no heap is required. The entry type is chosen
+ * at compile time; each type is identified by a tag that is appended to the
+ * buffer type and function names (e.g. circBufU16_t, writeCircBufU16).
+ *
+ * Hangwen Hu and Marc Katzef
+ * Last modified:  16.10.2026
+ */
+
+#include <stdint.h>
+#include "circBufT.h"
+
+/* *****************************************************************************
+ * Reader policy when the writer has overwritten entries it had not yet read
+ */
+typedef enum circBufOverrunPolicy {CIRCBUF_SKIP_TO_OLDEST = 0, CIRCBUF_SKIP_TO_NEWEST} circBufOverrunPolicy_t;
+
+/* *****************************************************************************
+ * CIRCBUF_STATIC_FUNCTIONS: declares the view type circBuf<tag>View_t and the
+ * prototypes of the functions shared by all buffer types:
+ *
+ * initCircBuf<tag>: empties the buffer and clears the data array. writeSeq
+ *     keeps counting, so readers stay attached (see below).
+ * writeCircBuf<tag>: inserts entry at the current windex location, advances
+ *     windex, modulo buffer size. Returns the entry that was replaced.
+ * readCircBuf<tag>: returns entry at the current rindex location, advances
+ *     rindex, modulo buffer size. Does not check if reading has advanced ahead
+ *     of writing.
+ * circBuf<tag>Peek: returns the entry written age writes ago (0 being the
+ *     newest) without moving rindex. age must be less than the buffer size.
+ * circBuf<tag>View: fills view with the two segments of the data array, oldest
+ *     entry first, without copying or moving rindex. Entries may be
+ *     overwritten by a concurrent write; use circBuf<tag>Snapshot for a
+ *     consistent copy.
+ * circBuf<tag>Snapshot: copies the count newest entries into dest, oldest
+ *     first, without moving rindex. Retries until the copy is consistent with a
+ *     single buffer state, so it is safe while writeCircBuf<tag> runs in an ISR
+ *     (but should not be called from an ISR that may preempt the writer).
+ *     Returns the number of entries copied, at most the buffer size.
+ *
+ * Any number of readers may also follow one writer. Each reader has its own
+ * cursor, so entries are stored once however many readers there are:
+ *
+ * initCircBuf<tag>Reader: attaches reader to buffer, positioned after the
+ *     newest entry, with the given overrun policy. A reader may be attached
+ *     before or after initCircBuf<tag>; entries it had not read when the buffer
+ *     was initialised are added to its drop count.
+ * readCircBuf<tag>Reader: copies the reader's next entry to *entry and
+ *     advances its cursor, or returns CIRCBUF_EMPTY if it has read every entry.
+ *     If the writer has lapped the reader, the entries lost are added to its
+ *     drop count and the cursor skips to the oldest or the newest entry,
+ *     according to its policy. Safe while writeCircBuf<tag> runs in an ISR.
+ * circBuf<tag>ReaderLag: returns the number of entries written that the reader
+ *     has not yet read, including any that have since been overwritten.
+ */
+#define CIRCBUF_STATIC_FUNCTIONS(tag, entryType) \
+	typedef struct { \
+		const entryType *first; \
+		uint32_t firstLength; \
+		const entryType *second; \
+		uint32_t secondLength; \
+	} circBuf##tag##View_t; \
+	typedef struct { \
+		circBuf##tag##_t *buffer;		/* buffer being read */ \
+		uint32_t readCount;				/* number of entries read or dropped */ \
+		uint32_t drops;					/* entries overwritten before being read */ \
+		circBufOverrunPolicy_t policy; \
+	} circBuf##tag##Reader_t; \
+	void initCircBuf##tag (circBuf##tag##_t *buffer); \
+	entryType writeCircBuf##tag (circBuf##tag##_t *buffer, entryType entry); \
+	entryType readCircBuf##tag (circBuf##tag##_t *buffer); \
+	entryType circBuf##tag##Peek (circBuf##tag##_t *buffer, uint32_t age); \
+	void circBuf##tag##View (circBuf##tag##_t *buffer, circBuf##tag##View_t *view); \
+	uint32_t circBuf##tag##Snapshot (circBuf##tag##_t *buffer, entryType *dest, uint32_t count); \
+	void initCircBuf##tag##Reader (circBuf##tag##Reader_t *reader, circBuf##tag##_t *buffer, \
+			circBufOverrunPolicy_t policy); \
+	circBufStatus_t readCircBuf##tag##Reader (circBuf##tag##Reader_t *reader, entryType *entry); \
+	uint32_t circBuf##tag##ReaderLag (circBuf##tag##Reader_t *reader)
+
+/* *****************************************************************************
+ * CIRCBUF_STATIC_TYPE: declares the buffer type circBuf<tag>_t holding entries
+ * of entryType, and its functions (see CIRCBUF_STATIC_FUNCTIONS).
+ */
+#define CIRCBUF_STATIC_TYPE(tag, entryType) \
+	typedef entryType circBuf##tag##Entry_t; \
+	typedef struct { \
+		entryType *data;	/* pointer to the data */ \
+		uint32_t mask;		/* number of entries in buffer - 1 */ \
+		uint32_t sizeLog2;	/* log2 of the number of entries in buffer */ \
+		uint32_t windex;	/* index for writing, mod(size) */ \
+		uint32_t rindex;	/* index for reading, mod(size) */ \
+		uint32_t writeSeq;	/* incremented before and after each write */ \
+		uint32_t initCount;	/* writes completed when last initialised */ \
+	} circBuf##tag##_t; \
+	CIRCBUF_STATIC_FUNCTIONS(tag, entryType)
+
+/* *****************************************************************************
+ * CIRCBUF_STATIC_SUM_TYPE: as CIRCBUF_STATIC_TYPE, for arithmetic entry types.
+ * The buffer also keeps a running sum of sumType, updated by writeCircBuf<tag>
+ * with the new entry and the entry it replaces, and declares:
+ *
+ * circBuf<tag>Mean: returns the mean of the entries in the data array from the
+ *     running sum. Takes constant time and does not move rindex.
+ */
+#define CIRCBUF_STATIC_SUM_TYPE(tag, entryType, sumType) \
+	typedef entryType circBuf##tag##Entry_t; \
+	typedef struct { \
+		entryType *data;	/* pointer to the data */ \
+		uint32_t mask;		/* number of entries in buffer - 1 */ \
+		uint32_t sizeLog2;	/* log2 of the number of entries in buffer */ \
+		uint32_t windex;	/* index for writing, mod(size) */ \
+		uint32_t rindex;	/* index for reading, mod(size) */ \
+		uint32_t writeSeq;	/* incremented before and after each write */ \
+		uint32_t initCount;	/* writes completed when last initialised */ \
+		sumType sum;		/* running sum of all entries in the data array */ \
+	} circBuf##tag##_t; \
+	CIRCBUF_STATIC_FUNCTIONS(tag, entryType); \
+	entryType circBuf##tag##Mean (circBuf##tag##_t *buffer)
+
+/* *****************************************************************************
+ * CIRCBUF_STATIC_DEFINE: defines a buffer instance called name, of the type
+ * identified by tag, holding 2^log2Size entries. The data array is
+ * zero-initialised in .bss, so the buffer is ready for use without a call to
+ * initCircBuf<tag>.
+ */
+#define CIRCBUF_STATIC_DEFINE(tag, name, log2Size) \
+	static circBuf##tag##Entry_t name##Data[1u << (log2Size)]; \
+	static circBuf##tag##_t name = {.data = name##Data, .mask = (1u << (log2Size)) - 1, \
+			.sizeLog2 = (log2Size)}
+
+/* *****************************************************************************
+ * Timestamped record, for logging samples with the time they were taken
+ */
+typedef struct {
+	uint32_t timestamp;
+	uint16_t value;
+} timedSample_t;
+
+/* *****************************************************************************
+ * Available buffer types
+ */
+CIRCBUF_STATIC_SUM_TYPE(U32, uint32_t, uint32_t);	// sum must fit in 32 bits
+CIRCBUF_STATIC_SUM_TYPE(U16, uint16_t, uint32_t);	// e.g. 12-bit ADC samples
+CIRCBUF_STATIC_SUM_TYPE(F32, float, float);			// e.g. filter states
+CIRCBUF_STATIC_TYPE(Timed, timedSample_t);
+
+#endif /*CIRCBUFSTATIC_H_*/
@@ -0,0 +1,158 @@
+/* *****************************************************************************
+ * circBufStats.c
+ *
+ * Windowed statistics companion to the circular buffer modules. Tracks the
+ * minimum, maximum, mean and variance of the most recent samples written to a
+ * buffer, with amortised constant time updates and constant time queries.
+ *
+ * Hangwen Hu and Marc Katzef
+ * Last modified:  16.10.2026
+ */
+
+#include "circBufStats.h"
+#include "circBufT.h"
+
+#include <stdint.h>
+
+
+/* *****************************************************************************
+ * initCircBufStats: empties the window. Should be called together with the
+ * initialisation of the companion buffer.
+ */
+void
+initCircBufStats (circBufStats_t *stats)
+{
+	stats->minHead = 0;
+	stats->minTail = 0;
+	stats->maxHead = 0;
+	stats->maxTail = 0;
+	stats->count = 0;
+	stats->sum = 0;
+	stats->sumSquares = 0;
+}
+
+
+/* *****************************************************************************
+ * circBufStatsUpdate: adds entry to the window. replaced is the entry the
+ * companion buffer discarded to make room for it, as returned by
+ * writeCircBuf<tag>. Amortised constant time. Intended to be called in the
+ * same context as the buffer write.
+ */
+void
+circBufStatsUpdate (circBufStats_t *stats, uint32_t entry, uint32_t replaced)
+{
+	uint32_t seq = stats->count;
+	uint32_t mask = stats->mask;
+	uint32_t head;
+	uint32_t tail;
+
+	stats->sum += entry - replaced;
+	stats->sumSquares += (uint64_t)entry * entry;
+	stats->sumSquares -= (uint64_t)replaced * replaced;
+
+	// Minimum: drop the expired head, then every larger sample behind the new one
+	head = stats->minHead;
+	tail = stats->minTail;
+	if (head != tail && seq - stats->minDeque[head & mask].seq > mask) {
+		head++;
+	}
+	while (tail != head && stats->minDeque[(tail - 1) & mask].value >= entry) {
+		tail--;
+	}
+	stats->minDeque[tail & mask].value = entry;
+	stats->minDeque[tail & mask].seq = seq;
+	stats->minHead = head;
+	stats->minTail = tail + 1;
+
+	// Maximum: as above, for smaller samples
+	head = stats->maxHead;
+	tail = stats->maxTail;
+	if (head != tail && seq - stats->maxDeque[head & mask].seq > mask) {
+		head++;
+	}
+	while (tail != head && stats->maxDeque[(tail - 1) & mask].value <= entry) {
+		tail--;
+	}
+	stats->maxDeque[tail & mask].value = entry;
+	stats->maxDeque[tail & mask].seq = seq;
+	stats->maxHead = head;
+	stats->maxTail = tail + 1;
+
+	CIRCBUF_MEMORY_BARRIER(); // Publish the new window before the count
+	stats->count = seq + 1;
+}
+
+
+/* *****************************************************************************
+ * circBufStatsMin: returns the smallest sample in the window, or 0 if no
+ * samples have been added. Safe to call while circBufStatsUpdate runs in an
+ * ISR.
+ */
+uint32_t
+circBufStatsMin (circBufStats_t *stats)
+{
+	uint32_t count;
+	uint32_t min;
+
+	do {
+		count = stats->count;
+		CIRCBUF_MEMORY_BARRIER();
+		min = stats->minDeque[stats->minHead & stats->mask].value;
+		CIRCBUF_MEMORY_BARRIER();
+	} while (count != stats->count); // Retry if a sample arrived meanwhile
+
+	return (count == 0) ? 0 : min;
+}
+
+
+/* *****************************************************************************
+ * circBufStatsMax: returns the largest sample in the window, or 0 if no samples
+ * have been added. Safe to call while circBufStatsUpdate runs in an ISR.
+ */
+uint32_t
+circBufStatsMax (circBufStats_t *stats)
+{
+	uint32_t count;
+	uint32_t max;
+
+	do {
+		count = stats->count;
+		CIRCBUF_MEMORY_BARRIER();
+		max = stats->maxDeque[stats->maxHead & stats->mask].value;
+		CIRCBUF_MEMORY_BARRIER();
+	} while (count != stats->count); // Retry if a sample arrived meanwhile
+
+	return (count == 0) ? 0 : max;
+}
+
+
+/* *****************************************************************************
+ * circBufStatsVariance: returns the population variance of the samples in the
+ * window (rounded down), or 0 if no samples have been added. Safe to call while
+ * circBufStatsUpdate runs in an ISR.
+ * NOTE: the sum of the window must fit in 32 bits.
+ */
+uint32_t
+circBufStatsVariance (circBufStats_t *stats)
+{
+	uint32_t count;
+	uint32_t sum;
+	uint64_t sumSquares;
+
+	do {
+		count = stats->count;
+		CIRCBUF_MEMORY_BARRIER();
+		sum = stats->sum;
+		sumSquares = stats->sumSquares;
+		CIRCBUF_MEMORY_BARRIER();
+	} while (count != stats->count); // Retry if a sample arrived meanwhile
+
+	if (count == 0) {
+		return 0;
+	}
+
+	uint64_t n = (count > stats->mask) ? stats->mask + 1 : count;
+
+	// n^2 * variance = n * sum(x^2) - sum(x)^2
+	return (n * sumSquares - (uint64_t)sum * sum) / (n * n);
+}
@@ -0,0 +1,96 @@
+#ifndef CIRCBUFSTATS_H_
+#define CIRCBUFSTATS_H_
+
+/* *****************************************************************************
+ * circBufStats.h
+ *
+ * Windowed statistics companion to the circular buffer modules. Tracks the
+ * minimum, maximum, mean and variance of the most recent samples written to a
+ * buffer, with amortised constant time updates and constant time queries.
+ *
+ * Minimum and maximum use monotonic deques of (value, sequence number) pairs.
+ * Variance uses exact integer first and second moments, so it does not drift.
+ *
+ * Hangwen Hu and Marc Katzef
+ * Last modified:  16.10.2026
+ */
+
+#include <stdint.h>
+
+/* *****************************************************************************
+ * Deque entry: a sample value and the sequence number it was written with
+ */
+typedef struct {
+	uint32_t value;
+	uint32_t seq;
+} circBufStatsEntry_t;
+
+/* *****************************************************************************
+ * Statistics structure
+ * The window size matches the companion buffer and is a power of two.
+ */
+typedef struct {
+	circBufStatsEntry_t *minDeque;	// values increasing from head to tail
+	circBufStatsEntry_t *maxDeque;	// values decreasing from head to tail
+	uint32_t mask;					// window size - 1
+	uint32_t minHead;				// free-running deque indices
+	uint32_t minTail;
+	uint32_t maxHead;
+	uint32_t maxTail;
+	volatile uint32_t count;		// number of samples added, sequence number
+	uint32_t sum;					// sum of the samples in the window
+	uint64_t sumSquares;			// sum of the squared samples in the window
+} circBufStats_t;
+
+/* *****************************************************************************
+ * CIRCBUF_STATS_DEFINE: defines a statistics instance called name for a window
+ * of 2^sizeLog2 samples. The deques are allocated in .bss, so the instance is
+ * ready for use without a call to initCircBufStats.
+ */
+#define CIRCBUF_STATS_DEFINE(name, sizeLog2) \
+	static circBufStatsEntry_t name##MinDeque[1u << (sizeLog2)]; \
+	static circBufStatsEntry_t name##MaxDeque[1u << (sizeLog2)]; \
+	static circBufStats_t name = {.minDeque = name##MinDeque, .maxDeque = name##MaxDeque, \
+			.mask = (1u << (sizeLog2)) - 1}
+
+/* *****************************************************************************
+ * initCircBufStats: empties the window. Should be called together with the
+ * initialisation of the companion buffer.
+ */
+void
+initCircBufStats (circBufStats_t *stats);
+
+/* *****************************************************************************
+ * circBufStatsUpdate: adds entry to the window. replaced is the entry the
+ * companion buffer discarded to make room for it, as returned by
+ * writeCircBuf<tag>. Amortised constant time. Intended to be called in the
+ * same context as the buffer write.
+ */
+void
+circBufStatsUpdate (circBufStats_t *stats, uint32_t entry, uint32_t replaced);
+
+/* *****************************************************************************
+ * circBufStatsMin: returns the smallest sample in the window, or 0 if no
+ * samples have been added. Safe to call while circBufStatsUpdate runs in an
+ * ISR.
+ */
+uint32_t
+circBufStatsMin (circBufStats_t *stats);
+
+/* *****************************************************************************
+ * circBufStatsMax: returns the largest sample in the window, or 0 if no samples
+ * have been added. Safe to call while circBufStatsUpdate runs in an ISR.
+ */
+uint32_t
+circBufStatsMax (circBufStats_t *stats);
+
+/* *****************************************************************************
+ * circBufStatsVariance: returns the population variance of the samples in the
+ * window (rounded down), or 0 if no samples have been added. Safe to call while
+ * circBufStatsUpdate runs in an ISR.
+ * NOTE: the sum of the window must fit in 32 bits.
+ */
+uint32_t
+circBufStatsVariance (circBufStats_t *stats);
+
+#endif /*CIRCBUFSTATS_H_*/
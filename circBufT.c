@@ -10,7 +10,6 @@
 #include "stdlib.h"
 #include "circBufT.h"
 
-
 /* *****************************************************************************
  * initCircBuf: initialise the circBuf instance. Resets both indices to the
  * start of the buffer.  Dynamically allocates and clears the memory and returns
@@ -22,6 +21,10 @@ initCircBuf (circBuf_t *buffer, uint32_t size)
 	buffer->windex = 0;
 	buffer->rindex = 0;
 	buffer->size = size;
+	buffer->sum = 0;
+	buffer->overruns = 0;
+	buffer->underruns = 0;
+	buffer->writeSeq = 0;
 	buffer->data = 
         (uint32_t *) calloc (size, sizeof(uint32_t));
 	return buffer->data;
@@ -30,15 +33,26 @@ initCircBuf (circBuf_t *buffer, uint32_t size)
 
 /* *****************************************************************************
  * writeCircBuf: inserts entry at the current windex location, advances windex,
- * modulo buffer size.
+ * modulo buffer size. The running sum is updated with the new entry and the
+ * entry it replaces.
  */
 void
 writeCircBuf (circBuf_t *buffer, uint32_t entry)
 {
-	buffer->data[buffer->windex] = entry;
-	buffer->windex++;
-	if (buffer->windex >= buffer->size)
-	   buffer->windex = 0;
+	uint32_t windex = buffer->windex;
+
+	CIRCBUF_SHARED(buffer->writeSeq) = buffer->writeSeq + 1; // Odd: writing
+	CIRCBUF_MEMORY_BARRIER();
+
+	buffer->sum += entry - buffer->data[windex];
+	CIRCBUF_SHARED(buffer->data[windex]) = entry;
+	windex++;
+	if (windex >= buffer->size)
+	   windex = 0;
+	CIRCBUF_SHARED(buffer->windex) = windex;
+
+	CIRCBUF_MEMORY_BARRIER();
+	CIRCBUF_SHARED(buffer->writeSeq) = buffer->writeSeq + 1; // Even: done
 }
 
 
@@ -60,6 +74,87 @@ readCircBuf (circBuf_t *buffer)
 }
 
 
+/* *****************************************************************************
+ * circBufPeek: returns the entry written age writes ago (0 being the newest)
+ * without moving rindex. age must be less than the buffer size.
+ */
+uint32_t
+circBufPeek (circBuf_t *buffer, uint32_t age)
+{
+	uint32_t windex = CIRCBUF_SHARED(buffer->windex);
+	uint32_t index;
+
+	if (windex > age)
+		index = windex - 1 - age;
+	else
+		index = buffer->size + windex - 1 - age;
+	return CIRCBUF_SHARED(buffer->data[index]);
+}
+
+
+/* *****************************************************************************
+ * circBufView: fills view with the two segments of the data array, oldest
+ * entry first, without copying or moving rindex. Entries may be overwritten by
+ * a concurrent writeCircBuf; use circBufSnapshot for a consistent copy.
+ */
+void
+circBufView (circBuf_t *buffer, circBufView_t *view)
+{
+	uint32_t windex = CIRCBUF_SHARED(buffer->windex);
+
+	view->first = &buffer->data[windex];
+	view->firstLength = buffer->size - windex;
+	view->second = buffer->data;
+	view->secondLength = windex;
+}
+
+
+/* *****************************************************************************
+ * circBufSnapshot: copies the count newest entries into dest, oldest first,
+ * without moving rindex. Retries until the copy is consistent with a single
+ * buffer state, so it is safe while writeCircBuf runs in an ISR (but should
+ * not be called from an ISR that may preempt the writer). Returns the number
+ * of entries copied, at most the buffer size.
+ */
+uint32_t
+circBufSnapshot (circBuf_t *buffer, uint32_t *dest, uint32_t count)
+{
+	uint32_t size = buffer->size;
+	uint32_t seqStart;
+	uint32_t writes;
+	uint32_t index;
+	uint32_t i;
+
+	if (count > size)
+		count = size;
+
+	do {
+		do {
+			seqStart = CIRCBUF_SHARED(buffer->writeSeq);
+		} while (seqStart & 1); // Wait for a write in progress to finish
+		CIRCBUF_MEMORY_BARRIER();
+
+		index = CIRCBUF_SHARED(buffer->windex) + size - count;
+		if (index >= size)
+			index -= size;
+
+		for (i = 0; i < count; i++) {
+			dest[i] = CIRCBUF_SHARED(buffer->data[index]);
+			index++;
+			if (index >= size)
+				index = 0;
+		}
+
+		// Writes replace the oldest entries first, so the copy is only
+		// invalid if more than (size - count) writes started meanwhile
+		CIRCBUF_MEMORY_BARRIER();
+		writes = (CIRCBUF_SHARED(buffer->writeSeq) - seqStart + 1) / 2;
+	} while (writes > size - count);
+
+	return count;
+}
+
+
 /* *****************************************************************************
  * freeCircBuf: releases the memory allocated to the buffer data, sets pointer
  * to NULL and other fields to 0. The buffer can be re-initialised by another
@@ -71,29 +166,99 @@ freeCircBuf (circBuf_t * buffer)
 	buffer->windex = 0;
 	buffer->rindex = 0;
 	buffer->size = 0;
+	buffer->sum = 0;
+	buffer->overruns = 0;
+	buffer->underruns = 0;
+	buffer->writeSeq = 0;
 	free (buffer->data);
 	buffer->data = NULL;
 }
 
 
+/* *****************************************************************************
+ * tryWriteCircBuf: single-producer queue write. Stores entry and publishes the
+ * new windex only if the buffer is not full, otherwise counts an overrun and
+ * returns CIRCBUF_FULL. At most size - 1 entries are queued at once. Safe
+ * against a concurrent tryReadCircBuf without disabling interrupts.
+ * NOTE: queue use does not maintain the running sum, so it should not be mixed
+ * with writeCircBuf/readCircBuf on the same buffer.
+ */
+circBufStatus_t
+tryWriteCircBuf (circBuf_t *buffer, uint32_t entry)
+{
+	uint32_t windex = buffer->windex;
+	uint32_t nextWindex = windex + 1;
+	if (nextWindex >= buffer->size)
+	   nextWindex = 0;
+
+	if (nextWindex == CIRCBUF_SHARED(buffer->rindex)) {
+		buffer->overruns++;
+		return CIRCBUF_FULL;
+	}
+
+	CIRCBUF_MEMORY_BARRIER(); // Acquire: slot freed by the reader before reuse
+	CIRCBUF_SHARED(buffer->data[windex]) = entry;
+	CIRCBUF_MEMORY_BARRIER(); // Release: entry stored before it is published
+	CIRCBUF_SHARED(buffer->windex) = nextWindex;
+	return CIRCBUF_OK;
+}
+
+
+/* *****************************************************************************
+ * tryReadCircBuf: single-consumer queue read. Copies the oldest queued entry
+ * to *entry and releases its slot, otherwise counts an underrun and returns
+ * CIRCBUF_EMPTY. Safe against a concurrent tryWriteCircBuf without disabling
+ * interrupts.
+ */
+circBufStatus_t
+tryReadCircBuf (circBuf_t *buffer, uint32_t *entry)
+{
+	uint32_t rindex = buffer->rindex;
+
+	if (rindex == CIRCBUF_SHARED(buffer->windex)) {
+		buffer->underruns++;
+		return CIRCBUF_EMPTY;
+	}
+
+	CIRCBUF_MEMORY_BARRIER(); // Acquire: entry read after its publication
+	*entry = CIRCBUF_SHARED(buffer->data[rindex]);
+	CIRCBUF_MEMORY_BARRIER(); // Release: entry read before its slot is freed
+
+	rindex++;
+	if (rindex >= buffer->size)
+	   rindex = 0;
+	CIRCBUF_SHARED(buffer->rindex) = rindex;
+	return CIRCBUF_OK;
+}
+
+
+/* *****************************************************************************
+ * circBufCount: returns the number of entries queued by tryWriteCircBuf that
+ * have not yet been read by tryReadCircBuf.
+ */
+uint32_t
+circBufCount (circBuf_t *buffer)
+{
+	uint32_t windex = CIRCBUF_SHARED(buffer->windex);
+	uint32_t rindex = CIRCBUF_SHARED(buffer->rindex);
+
+	if (windex >= rindex)
+		return windex - rindex;
+	return buffer->size - rindex + windex;
+}
+
+
 /* *****************************************************************************
  * circBufMean: calculates the mean of the current entries in the buffer's data
- * array. Returns the rounded result.
+ * array from the running sum. Returns the rounded result. Takes constant time
+ * regardless of buffer size and does not move rindex.
+ * NOTE: the sum of all entries must fit in 32 bits.
  */
 uint32_t
 circBufMean (circBuf_t *buffer)
 {
     uint32_t bufferSize = buffer->size;
 
-    int64_t circBufSum = 0;
-    uint32_t i;
-    for (i = 0; i < bufferSize; i++) {
-        circBufSum += readCircBuf(buffer);
-    }
-
-    uint32_t denom = 2 * bufferSize;
-    int64_t num = 2*circBufSum + bufferSize;
-
-    int32_t average = num / denom;
-    return average;
+    // Same rounding as (2 * sum + size) / (2 * size), with a 32-bit divide
+    return (buffer->sum + bufferSize / 2) / bufferSize;
 }
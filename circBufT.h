@@ -11,6 +11,29 @@
 
 #include <stdint.h>
 
+/* *****************************************************************************
+ * Memory barrier used to order index publication against data accesses when a
+ * buffer is shared between an ISR (or thread) and the foreground.
+ */
+#if defined(__TI_ARM__)
+#define CIRCBUF_MEMORY_BARRIER() __asm(" dmb")
+#elif defined(__GNUC__)
+#define CIRCBUF_MEMORY_BARRIER() __sync_synchronize()
+#else
+#define CIRCBUF_MEMORY_BARRIER()
+#endif
+
+/* *****************************************************************************
+ * Access to a uint32_t field that is shared between ISR and foreground
+ */
+#define CIRCBUF_SHARED(field) (*(volatile uint32_t *)&(field))
+
+/* *****************************************************************************
+ * Return codes for the single-producer/single-consumer functions, and for
+ * reads that may find no entry
+ */
+typedef enum circBufStatus {CIRCBUF_OK = 0, CIRCBUF_FULL, CIRCBUF_EMPTY} circBufStatus_t;
+
 /* *****************************************************************************
  * Buffer structure
  * Stores buffer properties and a pointer to the data array.
@@ -19,9 +42,24 @@ typedef struct {
 	uint32_t size;		// number of entries in buffer
 	uint32_t windex;	// index for writing, mod(size)
 	uint32_t rindex;	// index for reading, mod(size)
+	uint32_t sum;		// running sum of all entries in the data array
+	uint32_t overruns;	// failed tryWriteCircBuf calls (buffer full)
+	uint32_t underruns;	// failed tryReadCircBuf calls (buffer empty)
+	uint32_t writeSeq;	// incremented before and after each writeCircBuf
 	uint32_t *data;		// pointer to the data
 } circBuf_t;
 
+/* *****************************************************************************
+ * Read-only view of a buffer as two contiguous segments. Entries run from
+ * oldest to newest through first, then second.
+ */
+typedef struct {
+	const uint32_t *first;
+	uint32_t firstLength;
+	const uint32_t *second;
+	uint32_t secondLength;
+} circBufView_t;
+
 /* *****************************************************************************
  * initCircBuf: initialise the circBuf instance. Resets both indices to the
  * start of the buffer.  Dynamically allocates and clears the memory and returns
@@ -32,7 +70,8 @@ initCircBuf (circBuf_t *buffer, uint32_t size);
 
 /* *****************************************************************************
  * writeCircBuf: inserts entry at the current windex location, advances windex,
- * modulo buffer size.
+ * modulo buffer size. The running sum is updated with the new entry and the
+ * entry it replaces.
  */
 void
 writeCircBuf (circBuf_t *buffer, uint32_t entry);
@@ -45,6 +84,31 @@ writeCircBuf (circBuf_t *buffer, uint32_t entry);
 uint32_t
 readCircBuf (circBuf_t *buffer);
 
+/* *****************************************************************************
+ * circBufPeek: returns the entry written age writes ago (0 being the newest)
+ * without moving rindex. age must be less than the buffer size.
+ */
+uint32_t
+circBufPeek (circBuf_t *buffer, uint32_t age);
+
+/* *****************************************************************************
+ * circBufView: fills view with the two segments of the data array, oldest
+ * entry first, without copying or moving rindex. Entries may be overwritten by
+ * a concurrent writeCircBuf; use circBufSnapshot for a consistent copy.
+ */
+void
+circBufView (circBuf_t *buffer, circBufView_t *view);
+
+/* *****************************************************************************
+ * circBufSnapshot: copies the count newest entries into dest, oldest first,
+ * without moving rindex. Retries until the copy is consistent with a single
+ * buffer state, so it is safe while writeCircBuf runs in an ISR (but should
+ * not be called from an ISR that may preempt the writer). Returns the number
+ * of entries copied, at most the buffer size.
+ */
+uint32_t
+circBufSnapshot (circBuf_t *buffer, uint32_t *dest, uint32_t count);
+
 /* *****************************************************************************
  * freeCircBuf: releases the memory allocated to the buffer data, sets pointer
  * to NULL and other fields to 0. The buffer can be re-initialised by another
@@ -53,9 +117,38 @@ readCircBuf (circBuf_t *buffer);
 void
 freeCircBuf (circBuf_t *buffer);
 
+/* *****************************************************************************
+ * tryWriteCircBuf: single-producer queue write. Stores entry and publishes the
+ * new windex only if the buffer is not full, otherwise counts an overrun and
+ * returns CIRCBUF_FULL. At most size - 1 entries are queued at once. Safe
+ * against a concurrent tryReadCircBuf without disabling interrupts.
+ * NOTE: queue use does not maintain the running sum, so it should not be mixed
+ * with writeCircBuf/readCircBuf on the same buffer.
+ */
+circBufStatus_t
+tryWriteCircBuf (circBuf_t *buffer, uint32_t entry);
+
+/* *****************************************************************************
+ * tryReadCircBuf: single-consumer queue read. Copies the oldest queued entry
+ * to *entry and releases its slot, otherwise counts an underrun and returns
+ * CIRCBUF_EMPTY. Safe against a concurrent tryWriteCircBuf without disabling
+ * interrupts.
+ */
+circBufStatus_t
+tryReadCircBuf (circBuf_t *buffer, uint32_t *entry);
+
+/* *****************************************************************************
+ * circBufCount: returns the number of entries queued by tryWriteCircBuf that
+ * have not yet been read by tryReadCircBuf.
+ */
+uint32_t
+circBufCount (circBuf_t *buffer);
+
 /* *****************************************************************************
  * circBufMean: calculates the mean of the current entries in the buffer's data
- * array. Returns the rounded result.
+ * array from the running sum. Returns the rounded result. Takes constant time
+ * regardless of buffer size and does not move rindex.
+ * NOTE: the sum of all entries must fit in 32 bits.
  */
 uint32_t
 circBufMean (circBuf_t *buffer);
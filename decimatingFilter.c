@@ -0,0 +1,128 @@
+/* *****************************************************************************
+ * decimatingFilter.c
+ *
+ * Fixed-point CIC decimator and IIR (biquad) filter stages.
+ *
+ * Hangwen Hu and Marc Katzef
+ * Last modified:  16.10.2026
+ */
+
+#include "decimatingFilter.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* *****************************************************************************
+ * initCicDecimator: sets the decimator order (at most CIC_MAX_ORDER) and
+ * decimation factor (2^decimationLog2), and primes the integrators and combs
+ * as if initial had been the input for a long time, so that the first output
+ * is initial rather than a rise from zero. The DC gain of
+ * (2^decimationLog2)^order is removed from the output, which must fit in 32
+ * bits along with the input.
+ */
+void
+initCicDecimator (cicDecimator_t *cic, uint32_t order, uint32_t decimationLog2,
+		int32_t initial)
+{
+	uint32_t i;
+
+	if (order > CIC_MAX_ORDER) {
+		order = CIC_MAX_ORDER;
+	}
+	for (i = 0; i < CIC_MAX_ORDER; i++) {
+		cic->integrator[i] = 0;
+		cic->comb[i] = 0;
+	}
+	cic->order = order;
+	cic->decimationLog2 = decimationLog2;
+	cic->phase = 0;
+
+	// The decimator is an FIR filter of fewer than order << decimationLog2
+	// taps, so its output has settled after that many inputs
+	int32_t output;
+	for (i = 0; i < (order << decimationLog2); i++) {
+		cicDecimatorUpdate(cic, initial, &output);
+	}
+}
+
+
+/* *****************************************************************************
+ * cicDecimatorUpdate: adds an input sample. Every 2^decimationLog2 samples,
+ * stores the decimated value in *output and returns true. Otherwise returns
+ * false.
+ */
+bool
+cicDecimatorUpdate (cicDecimator_t *cic, int32_t sample, int32_t *output)
+{
+	uint32_t value = (uint32_t)sample;
+	uint32_t i;
+
+	// Integrators run at the input rate
+	for (i = 0; i < cic->order; i++) {
+		cic->integrator[i] += value;
+		value = cic->integrator[i];
+	}
+
+	cic->phase++;
+	if (cic->phase < (1u << cic->decimationLog2)) {
+		return false;
+	}
+	cic->phase = 0;
+
+	// Combs (differential delay of 1) run at the output rate
+	for (i = 0; i < cic->order; i++) {
+		uint32_t previous = cic->comb[i];
+		cic->comb[i] = value;
+		value -= previous;
+	}
+
+	// Remove the DC gain, with rounding
+	uint32_t gainLog2 = cic->order * cic->decimationLog2;
+	if (gainLog2 > 0) {
+		*output = ((int32_t)value + (1 << (gainLog2 - 1))) >> gainLog2;
+	} else {
+		*output = (int32_t)value;
+	}
+	return true;
+}
+
+
+/* *****************************************************************************
+ * initIirFilter: stores the given IIR_COEFF coefficients, and primes the
+ * filter history with initial, as if it had been the input for a long time.
+ */
+void
+initIirFilter (iirFilter_t *filter, int32_t b0, int32_t b1, int32_t b2,
+		int32_t a1, int32_t a2, int32_t initial)
+{
+	filter->b0 = b0;
+	filter->b1 = b1;
+	filter->b2 = b2;
+	filter->a1 = a1;
+	filter->a2 = a2;
+	filter->x1 = initial;
+	filter->x2 = initial;
+	filter->y1 = initial;
+	filter->y2 = initial;
+}
+
+
+/* *****************************************************************************
+ * iirFilterUpdate: adds an input sample and returns the new, rounded, output.
+ */
+int32_t
+iirFilterUpdate (iirFilter_t *filter, int32_t sample)
+{
+	int64_t acc = (int64_t)filter->b0 * sample +
+			(int64_t)filter->b1 * filter->x1 +
+			(int64_t)filter->b2 * filter->x2 -
+			(int64_t)filter->a1 * filter->y1 -
+			(int64_t)filter->a2 * filter->y2;
+	int32_t output = (int32_t)((acc + (1 << (IIR_COEFF_SHIFT - 1))) >> IIR_COEFF_SHIFT);
+
+	filter->x2 = filter->x1;
+	filter->x1 = sample;
+	filter->y2 = filter->y1;
+	filter->y1 = output;
+	return output;
+}
@@ -0,0 +1,83 @@
+#ifndef DECIMATINGFILTER_H_
+#define DECIMATINGFILTER_H_
+
+/* *****************************************************************************
+ * decimatingFilter.h
+ *
+ * Fixed-point filter pipeline stages for sampled signals: a cascaded
+ * integrator-comb (CIC) decimator, which reduces the sample rate with only
+ * additions, followed by a first or second order IIR (biquad) filter.
+ *
+ * Coefficients are fixed at compile time with IIR_COEFF, so no floating point
+ * is used at run time.
+ *
+ * Hangwen Hu and Marc Katzef
+ * Last modified:  16.10.2026
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* *****************************************************************************
+ * CIC decimator
+ */
+#define CIC_MAX_ORDER 4
+
+typedef struct {
+	uint32_t integrator[CIC_MAX_ORDER];	// modular arithmetic, so wrapping is harmless
+	uint32_t comb[CIC_MAX_ORDER];		// previous input to each comb
+	uint32_t order;
+	uint32_t decimationLog2;
+	uint32_t phase;						// input samples since the last output
+} cicDecimator_t;
+
+/* *****************************************************************************
+ * IIR filter. Direct form I biquad:
+ * y[n] = b0 x[n] + b1 x[n-1] + b2 x[n-2] - a1 y[n-1] - a2 y[n-2]
+ * A first order filter has b2 = a2 = 0.
+ */
+#define IIR_COEFF_SHIFT 14 // fractional bits of the coefficients
+#define IIR_COEFF(x) ((int32_t)((x) * (1 << IIR_COEFF_SHIFT) + ((x) < 0 ? -0.5 : 0.5)))
+
+typedef struct {
+	int32_t b0, b1, b2;
+	int32_t a1, a2;
+	int32_t x1, x2;
+	int32_t y1, y2;
+} iirFilter_t;
+
+/* *****************************************************************************
+ * initCicDecimator: sets the decimator order (at most CIC_MAX_ORDER) and
+ * decimation factor (2^decimationLog2), and primes the integrators and combs
+ * as if initial had been the input for a long time, so that the first output
+ * is initial rather than a rise from zero. The DC gain of
+ * (2^decimationLog2)^order is removed from the output, which must fit in 32
+ * bits along with the input.
+ */
+void
+initCicDecimator (cicDecimator_t *cic, uint32_t order, uint32_t decimationLog2,
+		int32_t initial);
+
+/* *****************************************************************************
+ * cicDecimatorUpdate: adds an input sample. Every 2^decimationLog2 samples,
+ * stores the decimated value in *output and returns true. Otherwise returns
+ * false.
+ */
+bool
+cicDecimatorUpdate (cicDecimator_t *cic, int32_t sample, int32_t *output);
+
+/* *****************************************************************************
+ * initIirFilter: stores the given IIR_COEFF coefficients, and primes the
+ * filter history with initial, as if it had been the input for a long time.
+ */
+void
+initIirFilter (iirFilter_t *filter, int32_t b0, int32_t b1, int32_t b2,
+		int32_t a1, int32_t a2, int32_t initial);
+
+/* *****************************************************************************
+ * iirFilterUpdate: adds an input sample and returns the new, rounded, output.
+ */
+int32_t
+iirFilterUpdate (iirFilter_t *filter, int32_t sample);
+
+#endif /* DECIMATINGFILTER_H_ */
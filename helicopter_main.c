@@ -20,6 +20,9 @@
 #include "altimeter.h"
 #include "buttons.h"
 #include "yawmeter.h"
+#include "nvStorage.h"
+#include "calibrationStore.h"
+#include "stateLatch.h"
 
 #include "OrbitOLEDInterface.h"
 #include <stdint.h>
@@ -43,22 +46,44 @@
 /* *****************************************************************************
  * Globals to module
  */
-// Position variables
-static uint16_t g_targetYaw;
+// Position variables of the main loop. The yaw target is kept in degrees, in
+// [0, 360), and converted to encoder counts where used, so that steps which
+// are not a whole number of counts do not accumulate rounding.
+static int32_t g_targetYaw;
 static uint8_t g_targetAlt;
-static uint16_t g_currentYaw;
+static int32_t g_currentYaw;
 static int16_t g_currentAlt;
 
+// Snapshots shared with the controller, each with one writer
+static stateLatch_t g_targetLatch; // targets, from the main loop
+static stateLatch_t g_flightLatch; // measurements and targets, from the controller
+static uint32_t g_controllerUpdates = 0;
+
 // Altitude and yaw controllers
-static pidController_t altController;
-static pidController_t yawController;
-static const double g_deltaT = 1.0 / CONTROL_UPDATE_FREQUENCY;
+static pidBatch_t g_controllers;
+static const pidReal_t g_deltaT = PID_CONST(1.0 / CONTROL_UPDATE_FREQUENCY);
+static const pidReal_t g_degreesPerCount = PID_CONST(360.0 / INTERRUPTS_PER_REV);
+static const pidReal_t g_tenth = PID_CONST(0.1);
+static const pidReal_t g_hundredth = PID_CONST(0.01);
+#ifdef PID_CYCLE_COUNT
+static volatile uint32_t g_pidCycles = 0; // by the latest controller update
+#endif
 
 // State variables
 static heliState_t g_state = IDLE;
 static bool g_flightModeActive = false;
 static uint8_t g_yawDebounce = 0;
 static uint8_t g_altDebounce = 0;
+static uint8_t g_groundDebounce = 0;
+
+// Yaw slip last sent through UART
+static uint32_t g_displayedYawSlip = 0;
+
+// Calibration saved for warm starts
+static bool g_nvStorageAvailable = false;
+static calibrationRecord_t g_calibrationRecord;
+static bool g_altCalibrationRestored = false; // offered, and not yet flown with
+static bool g_landed = false; // calibration to be saved once the motors are off
 
 /* *****************************************************************************
  * pollingIntHandler: polls altitude and buttons. Immediately identifies if
@@ -77,21 +102,49 @@ pollingIntHandler (void)
 
 
 /* *****************************************************************************
- * controllerIntHandler: calculates and adds altitude and yaw errors to
- * corresponding controllers. Sets the new control values to motors.
+ * controllerIntHandler: samples the altitude and yaw and publishes them with
+ * the latest targets as one snapshot for the main loop. Then calculates and
+ * adds altitude and yaw errors to corresponding controllers, and sets the new
+ * control values to motors.
  */
 void
 controllerIntHandler (void)
 {
+	flightState_t state;
+
 	TimerIntClear(TIMER0_BASE, TIMER_TIMA_TIMEOUT);
-	if (g_flightModeActive) {
-	    int16_t yawError = yawDifference(g_targetYaw, g_currentYaw);
 
-		double altControl = pidUpdate(&altController, g_targetAlt - g_currentAlt, g_deltaT);
-		double yawControl = pidUpdate(&yawController, yawError, g_deltaT);
+	readState(&g_targetLatch, &state); // Never waits, the main loop is preempted
+	state.timestamp = ++g_controllerUpdates;
+	state.altitude = getCurrentAltitude();
+	state.altitudeTenths = getCurrentAltitudeTenths();
+	state.altitudeRate = getAltitudeClimbRate();
+	state.yaw = getYawCount();
+	state.yawRate = getYawRate();
+	publishState(&g_flightLatch, &state);
 
-		setPWMMain(DEFAULT_FREQUENCY_MAIN, altControl);
-		setPWMTail(DEFAULT_FREQUENCY_TAIL, yawControl);
+	if (g_flightModeActive) {
+#ifdef PID_CYCLE_COUNT
+		uint32_t startCycles = HWREG(DWT_CYCCNT_REG);
+#endif
+		pidReal_t error[NUM_CONTROLLERS];
+		pidReal_t rate[NUM_CONTROLLERS];
+		pidReal_t control[NUM_CONTROLLERS];
+
+		error[ALT_CONTROLLER] = PID_SCALE_INT(state.targetAltitude * 10 - state.altitudeTenths, g_tenth);
+		rate[ALT_CONTROLLER] = PID_SCALE_INT(state.altitudeRate, g_tenth);
+		error[YAW_CONTROLLER] = PID_SCALE_INT(yawDifference(state.targetYaw, state.yaw), g_degreesPerCount);
+		rate[YAW_CONTROLLER] = PID_SCALE_INT(state.yawRate, g_hundredth);
+		pidBatchUpdate(&g_controllers, error, rate, control);
+
+		int32_t mainDuty = PID_TO_INT(control[ALT_CONTROLLER]);
+		int32_t tailDuty = PID_TO_INT(control[YAW_CONTROLLER]);
+#ifdef PID_CYCLE_COUNT
+		g_pidCycles = HWREG(DWT_CYCCNT_REG) - startCycles;
+#endif
+
+		setPWMMain(DEFAULT_FREQUENCY_MAIN, mainDuty);
+		setPWMTail(DEFAULT_FREQUENCY_TAIL, tailDuty);
 	}
 }
 
@@ -137,6 +190,21 @@ initControllerInterrupt (void)
 }
 
 
+#ifdef PID_CYCLE_COUNT
+/* *****************************************************************************
+ * initCycleCounter: enables the debug cycle counter, used to time the
+ * controller update.
+ */
+void
+initCycleCounter (void)
+{
+	HWREG(DEMCR_REG) |= DEMCR_TRCENA;
+	HWREG(DWT_CYCCNT_REG) = 0;
+	HWREG(DWT_CTRL_REG) |= DWT_CTRL_CYCCNTENA;
+}
+#endif
+
+
 /* *****************************************************************************
  * initConsole: initialises UART communication.
  * TODO: abstract the pins and peripherals using #defines.
@@ -154,6 +222,46 @@ initConsole(void)
 }
 
 
+/* *****************************************************************************
+ * restoreCalibration: loads the calibration saved by a previous run, if valid,
+ * and offers it to the altimeter and yawmeter. Each only uses it once its
+ * sensor confirms it, so a helicopter moved while powered off is recalibrated
+ * as usual.
+ */
+void
+restoreCalibration (void)
+{
+    g_nvStorageAvailable = initNvStorage();
+    if (g_nvStorageAvailable && loadCalibration(&g_calibrationRecord)) {
+        restoreAltimeterCalibration(g_calibrationRecord.altGroundADCValue);
+        g_altCalibrationRestored = true;
+        if (g_calibrationRecord.flags & CALIBRATION_YAW_AT_REF) {
+            restoreYawCalibration();
+        }
+    }
+}
+
+
+/* *****************************************************************************
+ * saveCurrentCalibration: saves the current altimeter calibration, and whether
+ * the helicopter is resting at the yaw reference point. Storage is only
+ * written if the record has changed.
+ */
+void
+saveCurrentCalibration (bool yawAtReference)
+{
+    uint32_t groundADCValue = getAltimeterGroundADCValue();
+    uint32_t flags = yawAtReference ? CALIBRATION_YAW_AT_REF : 0;
+
+    if (g_nvStorageAvailable && ((g_calibrationRecord.altGroundADCValue != groundADCValue) ||
+            (g_calibrationRecord.flags != flags) || (g_calibrationRecord.magic != CALIBRATION_MAGIC))) {
+        g_calibrationRecord.altGroundADCValue = groundADCValue;
+        g_calibrationRecord.flags = flags;
+        saveCalibration(&g_calibrationRecord);
+    }
+}
+
+
 /* *****************************************************************************
  * displayPosition: prints current information about the helicopter to the
  * Orbit's OLED display and through UART.
@@ -169,8 +277,8 @@ displayPosition (int yaw, int altitude)
 	OLEDStringDraw (oledString, 0, 0);
 	UARTprintf(uartString);
 
-	sprintf (oledString, "YAW: %3d [%3d]", g_currentYaw, g_targetYaw);
-	sprintf (uartString, "Yaw: %3d [%3d]\n", g_currentYaw, g_targetYaw);
+	sprintf (oledString, "YAW: %3d [%3d]", yaw, (int)g_targetYaw);
+	sprintf (uartString, "Yaw: %3d [%3d]\n", yaw, (int)g_targetYaw);
 	OLEDStringDraw (oledString, 0, 1);
 	UARTprintf(uartString);
 
@@ -188,7 +296,11 @@ displayPosition (int yaw, int altitude)
 		sprintf (uartString, "Mode: idle\n");
 		break;
 	case TAKING_OFF:
-		sprintf (uartString, "Mode: taking off\n");
+		if (altimeterCalibrated_p()) {
+			sprintf (uartString, "Mode: taking off\n");
+		} else {
+			sprintf (uartString, "Mode: calibrating %3d%%\n", getAltimeterCalibrationProgress());
+		}
 		break;
 	case FLYING:
 		sprintf (uartString, "Mode: flying\n");
@@ -199,13 +311,27 @@ displayPosition (int yaw, int altitude)
 	}
 	UARTprintf(uartString);
 
+	// Changes only at the reference point, so only sent when it does
+	uint32_t yawSlip = getYawSlip();
+	if (yawSlip != g_displayedYawSlip) {
+		sprintf (uartString, "Yaw slip: %u.%02u/rev\n", yawSlip / 100, yawSlip % 100);
+		UARTprintf(uartString);
+		g_displayedYawSlip = yawSlip;
+	}
+#ifdef PID_CYCLE_COUNT
+	sprintf (uartString, "PID cycles: %u\n", g_pidCycles);
+	UARTprintf(uartString);
+#endif
+
 	UARTprintf("----------\n");
 }
 
 
 /* *****************************************************************************
- * updateStateIdle: disables the main and tail motor upon state entry, reads
- * input updates. Returns the next state to assume - IDLE or TAKING_OFF.
+ * updateStateIdle: disables the main and tail motor upon state entry, then
+ * saves the calibration if the helicopter has just landed (EEPROM is not
+ * written while the motors run). Reads input updates. Returns the next state
+ * to assume - IDLE or TAKING_OFF.
  */
 heliState_t
 updateStateIdle (bool justChangedState)
@@ -216,11 +342,20 @@ updateStateIdle (bool justChangedState)
         disableMainMotor();
         disableTailMotor();
         g_flightModeActive = false;
+        if (g_landed) {
+            saveCurrentCalibration(yawCalibrated_p());
+            g_landed = false;
+        }
     }
 
     if (checkButton(SLIDE_RIGHT) == PUSHED) {
-        initPidController(&altController, KP_ALT, KI_ALT, KD_ALT);
-        initPidController(&yawController, KP_YAW, KI_YAW, KD_YAW);
+        initPidBatch(&g_controllers, NUM_CONTROLLERS);
+        setPidBatchController(&g_controllers, ALT_CONTROLLER, PID_CONST(KP_ALT),
+                PID_CONST(KI_ALT), PID_CONST(KD_ALT), PID_CONST(TF_ALT), PID_CONST(TT_ALT),
+                g_deltaT, PID_FROM_INT(DUTY_MIN_MAIN), PID_FROM_INT(DUTY_MAX_MAIN));
+        setPidBatchController(&g_controllers, YAW_CONTROLLER, PID_CONST(KP_YAW),
+                PID_CONST(KI_YAW), PID_CONST(KD_YAW), PID_CONST(TF_YAW), PID_CONST(TT_YAW),
+                g_deltaT, PID_FROM_INT(DUTY_MIN_TAIL), PID_FROM_INT(DUTY_MAX_TAIL));
         g_targetAlt = YAW_CORRECTION_ALT;
         resultState = TAKING_OFF;
     }
@@ -230,7 +365,9 @@ updateStateIdle (bool justChangedState)
 
 
 /* *****************************************************************************
- * updateStateTakingOff: rotates the helicopter to find the calibration point.
+ * updateStateTakingOff: waits for the altimeter to be calibrated, then rotates
+ * the helicopter to find the calibration point. Motors are only enabled once
+ * the altimeter is calibrated, so inputs continue to be serviced meanwhile.
  * Initialises the yaw after detecting the calibration point and returns
  * state FLYING. Until then, TAKING_OFF or IDLE (if mode switch flipped).
  */
@@ -240,10 +377,12 @@ updateStateTakingOff (bool justChangedState)
     heliState_t resultState = TAKING_OFF;
 
     if (justChangedState) {
-        calibrateAltimeter();
-        enableMainMotor();
-        enableTailMotor();
-        g_flightModeActive = true;
+        // The first take-off keeps a restored calibration, which the
+        // altimeter confirms (or replaces) against the ground samples
+        if (!g_altCalibrationRestored) {
+            startAltimeterCalibration();
+        }
+        g_altCalibrationRestored = false;
         g_targetAlt = YAW_CORRECTION_ALT;
         g_yawDebounce = 0;
     }
@@ -251,16 +390,23 @@ updateStateTakingOff (bool justChangedState)
     // Check if flight disabled
     if (checkButton(SLIDE_RIGHT) == RELEASED) {
         resultState = IDLE;
+    } else if (!g_flightModeActive) {
+        // Motors wait for the ground altitude to be calibrated
+        if (altimeterCalibrated_p()) {
+            saveCurrentCalibration(false); // No longer resting at the reference
+            enableMainMotor();
+            enableTailMotor();
+            g_flightModeActive = true;
+        }
     } else {
         if (yawCalibrated_p()) {
             g_targetYaw = 0;
-            disableYawRefInt(); // Prevent undesired re-calibration
             resultState = FLYING;
         } else {
-            int32_t yawError = abs(yawDifference(g_targetYaw, g_currentYaw));
+            int32_t yawError = abs(yawDifference(YAW_DEGREES_TO_COUNTS(g_targetYaw), g_currentYaw));
             int32_t altError = abs((int32_t)g_targetAlt - g_currentAlt);
 
-            if ((yawError < YAW_TAKEOFF_TOLERANCE) && (altError < ALT_TOLERANCE)) {
+            if ((yawError < YAW_DEGREES_TO_COUNTS(YAW_TAKEOFF_TOLERANCE)) && (altError < ALT_TOLERANCE)) {
                 g_yawDebounce++;
                 if (g_yawDebounce > YAW_MIN_POLLS) {
                     int32_t newTargetYaw = g_targetYaw + YAW_REF_INCREMENT;
@@ -281,7 +427,8 @@ updateStateTakingOff (bool justChangedState)
 
 /* *****************************************************************************
  * updateStateFlying: uses direction buttons to change the helicopter target
- * position. Reads mode switch to enter LANDING state.
+ * position, and lowers the target if the altitude ceiling is reached. Reads
+ * mode switch to enter LANDING state.
  */
 heliState_t
 updateStateFlying (bool justChangedState)
@@ -291,6 +438,9 @@ updateStateFlying (bool justChangedState)
     if (checkButton(SLIDE_RIGHT) == RELEASED) {
         resultState = LANDING;
     } else {
+        if (checkAltitudeEvent(ALT_LIMIT_CEILING)) {
+            g_targetAlt = MIN(g_targetAlt, ALT_CEILING_RETREAT);
+        }
         if (checkButton(UP) == PUSHED) {
             g_targetAlt = MIN(100, g_targetAlt + INCREMENT_ALT);
         }
@@ -315,7 +465,8 @@ updateStateFlying (bool justChangedState)
 
 /* *****************************************************************************
  * updateStateLanding: rotates helicopter to reference point and descends.
- * Returns state IDLE if altitude is 0%. 
+ * Returns state IDLE once the altitude has stayed within the ground limit for
+ * GROUND_MIN_POLLS passes; IDLE then saves the calibration for a warm start.
  */
 heliState_t updateStateLanding (bool justChangedState)
 {
@@ -324,20 +475,21 @@ heliState_t updateStateLanding (bool justChangedState)
     if (justChangedState) {
         g_yawDebounce = 0;
         g_altDebounce = 0;
+        g_groundDebounce = 0;
     }
 
     if (checkButton(SLIDE_RIGHT) == PUSHED) {
         resultState = FLYING;
     } else {
-        int32_t yawError = abs(yawDifference(g_targetYaw, g_currentYaw));
+        int32_t yawError = abs(yawDifference(YAW_DEGREES_TO_COUNTS(g_targetYaw), g_currentYaw));
 
-        if (yawError < YAW_LANDING_TOLERANCE) {
+        if (yawError < YAW_DEGREES_TO_COUNTS(YAW_LANDING_TOLERANCE)) {
             g_yawDebounce++;
             if (g_yawDebounce > YAW_MIN_POLLS) {
                 if (g_targetYaw != 0) {
                     int32_t newTargetYaw;
-                    if (yawDifference(0, g_targetYaw) < 0) {
-                        newTargetYaw = MAX(0, ((int32_t)g_targetYaw) - YAW_REF_INCREMENT);
+                    if (g_targetYaw <= 180) {
+                        newTargetYaw = MAX(0, g_targetYaw - YAW_REF_INCREMENT);
                     } else {
                         newTargetYaw = g_targetYaw + YAW_REF_INCREMENT;
                         if (newTargetYaw >= 360) {
@@ -352,10 +504,17 @@ heliState_t updateStateLanding (bool justChangedState)
         }
 
         yawError = abs(yawDifference(0, g_currentYaw));
-        if (yawError < YAW_LANDING_TOLERANCE) {
-            if (g_currentAlt <= LANDING_MAX_ALT) {
-                resultState = IDLE;
+        if (yawError < YAW_DEGREES_TO_COUNTS(YAW_LANDING_TOLERANCE)) {
+            // The comparator has little hysteresis, so the filtered altitude
+            // must agree for several passes
+            if (altitudeLimitActive_p(ALT_LIMIT_GROUND) && (g_currentAlt <= LANDING_MAX_ALT)) {
+                g_groundDebounce++;
+                if (g_groundDebounce > GROUND_MIN_POLLS) {
+                    g_landed = true;
+                    resultState = IDLE;
+                }
             } else {
+                g_groundDebounce = 0;
                 int32_t altError = abs((int32_t)g_targetAlt - g_currentAlt);
 
                 if (altError < ALT_TOLERANCE) {
@@ -382,11 +541,20 @@ heliState_t updateStateLanding (bool justChangedState)
 int
 main(void)
 {
+	flightState_t state = {0};
+
 	initClock();
+	initStateLatch(&g_targetLatch, &state);
+	initStateLatch(&g_flightLatch, &state);
 	OLEDInitialise ();
 	initAltimeter();
+	setAltitudeLimits(LANDING_MAX_ALT, ALT_CEILING);
 	initYawmeter();
+	restoreCalibration();
 	initMotors();
+#ifdef PID_CYCLE_COUNT
+	initCycleCounter();
+#endif
 	initControllerInterrupt();
 	initConsole();
 	initButtons();
@@ -399,9 +567,10 @@ main(void)
 
 	while (1)
 	{
-		g_currentAlt = getCurrentAltitude();
-		g_currentYaw = getCurrentYaw();
-		displayPosition (g_currentYaw, g_currentAlt);
+		readState(&g_flightLatch, &state);
+		g_currentAlt = state.altitude;
+		g_currentYaw = state.yaw;
+		displayPosition (YAW_COUNTS_TO_DEGREES(g_currentYaw), g_currentAlt);
 
 		switch (g_state) {
 		case IDLE:
@@ -426,6 +595,11 @@ main(void)
 		} else {
 		    justChangedState = true;
             g_state = newState;
+            clearAltitudeEvents(); // Crossings before the new state are stale
 		}
+
+		state.targetAltitude = g_targetAlt;
+		state.targetYaw = YAW_DEGREES_TO_COUNTS(g_targetYaw);
+		publishState(&g_targetLatch, &state);
 	}
 }
@@ -24,11 +24,15 @@
 #define KP_ALT 1
 #define KI_ALT 0.5
 #define KD_ALT 0.2
+#define TF_ALT 0.02 // derivative filter time constant (s)
+#define TT_ALT 0.6 // anti-windup tracking time constant (s), about sqrt(Ti * Td)
 
 // Yaw
 #define KP_YAW 1
 #define KI_YAW 0.2
 #define KD_YAW 0.2
+#define TF_YAW 0.02
+#define TT_YAW 1.0
 
 /* *****************************************************************************
  * Position parameters
@@ -45,9 +49,12 @@
 
 #define ALT_TOLERANCE 8
 #define YAW_CORRECTION_ALT 10
-#define LANDING_MAX_ALT 3
+#define LANDING_MAX_ALT 3 // ground limit of the altimeter comparator
+#define ALT_CEILING 105 // ceiling limit of the altimeter comparator
+#define ALT_CEILING_RETREAT 90 // target altitude after reaching the ceiling
 #define ALT_LANDING_INCREMENT 10
 #define ALT_MIN_POLLS 10
+#define GROUND_MIN_POLLS 5 // passes on the ground, by comparator and filtered altitude, to land
 
 /* *****************************************************************************
  * Timing and peripherals
@@ -63,6 +70,14 @@
 #define CONTROLLER_TIMER_INT INT_TIMER0A
 #define CONTROLLER_TIMER_INT_MODE TIMER_TIMA_TIMEOUT
 
+// Cycle counter, for reporting the time taken by the controllers when built
+// with PID_CYCLE_COUNT defined
+#define DEMCR_REG 0xE000EDFC
+#define DEMCR_TRCENA 0x01000000
+#define DWT_CTRL_REG 0xE0001000
+#define DWT_CTRL_CYCCNTENA 0x00000001
+#define DWT_CYCCNT_REG 0xE0001004
+
 // UART
 #define BAUD_RATE 9600
 #define UART_CLK_FREQ 16000000
@@ -75,5 +90,6 @@
  * Constants
  */
 typedef enum heliState {IDLE = 0, TAKING_OFF, FLYING, LANDING, NUM_HELI_STATES} heliState_t;
+typedef enum controllerIndex {ALT_CONTROLLER = 0, YAW_CONTROLLER, NUM_CONTROLLERS} controllerIndex_t;
 
 #endif /* HELICOPTER_MAIN_H_ */
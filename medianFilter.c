@@ -0,0 +1,184 @@
+/* *****************************************************************************
+ * medianFilter.c
+ *
+ * Sliding median over the window of a static uint16_t circular buffer, using a
+ * pair of indexed heaps for O(log n) updates.
+ *
+ * Hangwen Hu and Marc Katzef
+ * Last modified:  16.10.2026
+ */
+
+#include "medianFilter.h"
+#include "circBufT.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* *****************************************************************************
+ * Heap helpers. Both heaps share one array: the lower (max) heap occupies
+ * [0, lowSize) and the upper (min) heap [lowSize, size). Positions and the
+ * indices passed to swapHeapEntries and higherPriority are absolute indices
+ * into the shared array; only siftHeap takes an index relative to the start of
+ * the heap (its base).
+ */
+#define SLOT_VALUE(filter, slot) ((filter)->window->data[(slot)])
+
+
+/* *****************************************************************************
+ * swapHeapEntries: exchanges two heap entries and updates their positions.
+ */
+static void
+swapHeapEntries (medianFilter_t *filter, uint32_t a, uint32_t b)
+{
+	uint16_t slotA = filter->heap[a];
+	uint16_t slotB = filter->heap[b];
+
+	filter->heap[a] = slotB;
+	filter->heap[b] = slotA;
+	filter->position[slotB] = a;
+	filter->position[slotA] = b;
+}
+
+
+/* *****************************************************************************
+ * higherPriority: returns true if heap entry a should sit above heap entry b.
+ * Lower heap entries rise with larger values, upper heap entries with smaller.
+ */
+static bool
+higherPriority (medianFilter_t *filter, bool lower, uint32_t a, uint32_t b)
+{
+	uint16_t valueA = SLOT_VALUE(filter, filter->heap[a]);
+	uint16_t valueB = SLOT_VALUE(filter, filter->heap[b]);
+
+	return lower ? (valueA > valueB) : (valueA < valueB);
+}
+
+
+/* *****************************************************************************
+ * siftHeap: restores the order of the heap starting at base with count entries
+ * after the entry at index (relative to base) has changed value.
+ */
+static void
+siftHeap (medianFilter_t *filter, bool lower, uint32_t base, uint32_t count, uint32_t index)
+{
+	// Up
+	while (index > 0) {
+		uint32_t parent = (index - 1) / 2;
+		if (!higherPriority(filter, lower, base + index, base + parent)) {
+			break;
+		}
+		swapHeapEntries(filter, base + index, base + parent);
+		index = parent;
+	}
+
+	// Down
+	while (1) {
+		uint32_t child = 2 * index + 1;
+		if (child >= count) {
+			break;
+		}
+		if (child + 1 < count && higherPriority(filter, lower, base + child + 1, base + child)) {
+			child++;
+		}
+		if (!higherPriority(filter, lower, base + child, base + index)) {
+			break;
+		}
+		swapHeapEntries(filter, base + index, base + child);
+		index = child;
+	}
+}
+
+
+/* *****************************************************************************
+ * initMedianFilter: attaches the filter to window and builds the heaps from
+ * its current contents.
+ */
+void
+initMedianFilter (medianFilter_t *filter, circBufU16_t *window)
+{
+	uint32_t size = window->mask + 1;
+	uint32_t i;
+
+	filter->window = window;
+	filter->lowSize = (size + 1) / 2;
+	filter->updates = 0;
+
+	for (i = 0; i < size; i++) {
+		filter->heap[i] = i;
+		filter->position[i] = i;
+	}
+
+	// Insert every slot into the lower heap, then move the largest half across
+	for (i = 1; i < size; i++) {
+		siftHeap(filter, true, 0, i + 1, i);
+	}
+	for (i = size - 1; i >= filter->lowSize; i--) {
+		swapHeapEntries(filter, 0, i);			// Largest to the end
+		siftHeap(filter, true, 0, i, 0);
+	}
+	for (i = filter->lowSize; i < size; i++) {
+		siftHeap(filter, false, filter->lowSize, i - filter->lowSize + 1, i - filter->lowSize);
+	}
+}
+
+
+/* *****************************************************************************
+ * medianFilterUpdate: repositions the newest entry of the window in the heaps.
+ * Must be called once after every writeCircBufU16 on the window. O(log n).
+ */
+void
+medianFilterUpdate (medianFilter_t *filter)
+{
+	uint32_t size = filter->window->mask + 1;
+	uint32_t lowSize = filter->lowSize;
+	uint16_t slot = (filter->window->windex - 1) & filter->window->mask;
+	uint32_t index = filter->position[slot];
+
+	if (index < lowSize) {
+		siftHeap(filter, true, 0, lowSize, index);
+	} else {
+		siftHeap(filter, false, lowSize, size - lowSize, index - lowSize);
+	}
+
+	// Every lower value must not exceed every upper value; exchanging the tops
+	// once restores this after a single change
+	if (size > 1 && SLOT_VALUE(filter, filter->heap[0]) > SLOT_VALUE(filter, filter->heap[lowSize])) {
+		swapHeapEntries(filter, 0, lowSize);
+		siftHeap(filter, true, 0, lowSize, 0);
+		siftHeap(filter, false, lowSize, size - lowSize, 0);
+	}
+
+	CIRCBUF_MEMORY_BARRIER();
+	filter->updates++;
+}
+
+
+/* *****************************************************************************
+ * medianFilterValue: returns the median of the window. For an even window size
+ * this is the rounded mean of the two middle values. Safe to call while
+ * medianFilterUpdate runs in an ISR.
+ */
+uint16_t
+medianFilterValue (medianFilter_t *filter)
+{
+	uint32_t size = filter->window->mask + 1;
+	uint32_t updates;
+	uint32_t lowTop;
+	uint32_t highTop = 0;
+
+	do {
+		updates = filter->updates;
+		CIRCBUF_MEMORY_BARRIER();
+		lowTop = SLOT_VALUE(filter, filter->heap[0]);
+		if (!(size & 1)) {
+			// The upper heap is empty for a one-entry window
+			highTop = SLOT_VALUE(filter, filter->heap[filter->lowSize]);
+		}
+		CIRCBUF_MEMORY_BARRIER();
+	} while (updates != filter->updates); // Retry if a sample arrived meanwhile
+
+	if (size & 1) {
+		return lowTop;
+	}
+	return (lowTop + highTop + 1) / 2;
+}
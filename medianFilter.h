@@ -0,0 +1,63 @@
+#ifndef MEDIANFILTER_H_
+#define MEDIANFILTER_H_
+
+/* *****************************************************************************
+ * medianFilter.h
+ *
+ * Sliding median over the window of a static uint16_t circular buffer.
+ *
+ * The window is split into a max-heap of its lower half and a min-heap of its
+ * upper half. Each heap holds buffer slot numbers rather than values, and each
+ * slot records where it sits in the heaps, so the slot replaced by a new write
+ * can be repositioned in O(log n) without sorting.
+ *
+ * Hangwen Hu and Marc Katzef
+ * Last modified:  16.10.2026
+ */
+
+#include <stdint.h>
+#include "circBufStatic.h"
+
+/* *****************************************************************************
+ * Filter structure
+ */
+typedef struct {
+	circBufU16_t *window;		// buffer holding the sample values
+	uint16_t *heap;				// [0, lowSize): lower max-heap, then upper min-heap
+	uint16_t *position;			// index in heap of each buffer slot
+	uint32_t lowSize;			// number of slots in the lower heap
+	volatile uint32_t updates;	// number of calls to medianFilterUpdate
+} medianFilter_t;
+
+/* *****************************************************************************
+ * MEDIAN_FILTER_DEFINE: defines a filter instance called name for a buffer of
+ * 2^sizeLog2 entries. initMedianFilter must be called before use.
+ */
+#define MEDIAN_FILTER_DEFINE(name, sizeLog2) \
+	static uint16_t name##Heap[1u << (sizeLog2)]; \
+	static uint16_t name##Position[1u << (sizeLog2)]; \
+	static medianFilter_t name = {.heap = name##Heap, .position = name##Position}
+
+/* *****************************************************************************
+ * initMedianFilter: attaches the filter to window and builds the heaps from
+ * its current contents.
+ */
+void
+initMedianFilter (medianFilter_t *filter, circBufU16_t *window);
+
+/* *****************************************************************************
+ * medianFilterUpdate: repositions the newest entry of the window in the heaps.
+ * Must be called once after every writeCircBufU16 on the window. O(log n).
+ */
+void
+medianFilterUpdate (medianFilter_t *filter);
+
+/* *****************************************************************************
+ * medianFilterValue: returns the median of the window. For an even window size
+ * this is the rounded mean of the two middle values. Safe to call while
+ * medianFilterUpdate runs in an ISR.
+ */
+uint16_t
+medianFilterValue (medianFilter_t *filter);
+
+#endif /*MEDIANFILTER_H_*/
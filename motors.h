@@ -15,10 +15,24 @@
  */
 
 #include <stdint.h>
+#include "yawmeter.h" // YAW_BACKEND selects the main PWM pin
 
 /* *****************************************************************************
  * Peripheral definitions
  */
+#if YAW_BACKEND == YAW_BACKEND_QEI
+// Main motor PWM: M1PWM6, PF2, J4-01. PC5 is taken by the yaw QEI (see the pin
+// budget in yawmeter.h)
+#define PWM_MAIN_BASE	     PWM1_BASE
+#define PWM_MAIN_GEN         PWM_GEN_3
+#define PWM_MAIN_OUTNUM      PWM_OUT_6
+#define PWM_MAIN_OUTBIT      PWM_OUT_6_BIT
+#define PWM_MAIN_PERIPH_PWM	 SYSCTL_PERIPH_PWM1
+#define PWM_MAIN_PERIPH_GPIO SYSCTL_PERIPH_GPIOF
+#define PWM_MAIN_GPIO_BASE   GPIO_PORTF_BASE
+#define PWM_MAIN_GPIO_CONFIG GPIO_PF2_M1PWM6
+#define PWM_MAIN_GPIO_PIN    GPIO_PIN_2
+#else
 // Main motor PWM: M0PWM7, PC5, J4-05
 #define PWM_MAIN_BASE	     PWM0_BASE
 #define PWM_MAIN_GEN         PWM_GEN_3
@@ -29,6 +43,7 @@
 #define PWM_MAIN_GPIO_BASE   GPIO_PORTC_BASE
 #define PWM_MAIN_GPIO_CONFIG GPIO_PC5_M0PWM7
 #define PWM_MAIN_GPIO_PIN    GPIO_PIN_5
+#endif
 #define DEFAULT_FREQUENCY_MAIN 150
 #define DEFAULT_DUTY_CYCLE_MAIN 0
 #define DUTY_MAX_MAIN 98
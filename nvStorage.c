@@ -0,0 +1,76 @@
+/* *****************************************************************************
+ * nvStorage.c
+ *
+ * Non-volatile storage for small records, using the TM4C123 on-chip EEPROM.
+ *
+ * Hangwen Hu and Marc Katzef
+ * Last modified:  16.10.2026
+ */
+
+#include "nvStorage.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "inc/hw_memmap.h"
+#include "inc/hw_types.h"
+#include "driverlib/eeprom.h"
+#include "driverlib/sysctl.h"
+
+static bool g_nvStorageReady = false;
+
+/* *****************************************************************************
+ * validNvRange: returns true if [address, address + length) is word aligned
+ * and lies within the storage.
+ */
+static bool
+validNvRange (uint32_t address, uint32_t length)
+{
+	return g_nvStorageReady && ((address & 3) == 0) && ((length & 3) == 0) &&
+			(address <= NV_STORAGE_SIZE) && (length <= NV_STORAGE_SIZE - address);
+}
+
+
+/* *****************************************************************************
+ * initNvStorage: enables the storage peripheral and recovers it from any
+ * interrupted write. Returns false if the storage cannot be used.
+ */
+bool
+initNvStorage (void)
+{
+	SysCtlPeripheralEnable(SYSCTL_PERIPH_EEPROM0);
+	while (!SysCtlPeripheralReady(SYSCTL_PERIPH_EEPROM0)) {
+		continue;
+	}
+
+	g_nvStorageReady = (EEPROMInit() == EEPROM_INIT_OK);
+	return g_nvStorageReady;
+}
+
+
+/* *****************************************************************************
+ * readNvStorage: copies length bytes starting at address into data. Returns
+ * false if the range is invalid or the storage is unavailable.
+ */
+bool
+readNvStorage (uint32_t address, uint32_t *data, uint32_t length)
+{
+	if (!validNvRange(address, length)) {
+		return false;
+	}
+	EEPROMRead(data, address, length);
+	return true;
+}
+
+
+/* *****************************************************************************
+ * writeNvStorage: programs length bytes from data starting at address.
+ * Blocks until programming is complete. Returns false on failure.
+ */
+bool
+writeNvStorage (uint32_t address, const uint32_t *data, uint32_t length)
+{
+	if (!validNvRange(address, length)) {
+		return false;
+	}
+	return EEPROMProgram((uint32_t *)data, address, length) == 0;
+}
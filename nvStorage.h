@@ -0,0 +1,48 @@
+#ifndef NVSTORAGE_H_
+#define NVSTORAGE_H_
+
+/* *****************************************************************************
+ * nvStorage.h
+ *
+ * Non-volatile storage for small records, such as calibration results.
+ *
+ * nvStorage.c implements this interface with the TM4C123 on-chip EEPROM.
+ * Modules using it depend only on these functions, so a stand-in (e.g. backed
+ * by a file) can be linked in its place to exercise them off-target.
+ *
+ * Hangwen Hu and Marc Katzef
+ * Last modified:  16.10.2026
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* *****************************************************************************
+ * Storage layout. Addresses and lengths are in bytes, and must be multiples
+ * of 4 (one EEPROM word).
+ */
+#define NV_STORAGE_SIZE 2048 // TM4C123GH6PM EEPROM
+#define NV_CALIBRATION_ADDRESS 0
+
+/* *****************************************************************************
+ * initNvStorage: enables the storage peripheral and recovers it from any
+ * interrupted write. Returns false if the storage cannot be used.
+ */
+bool
+initNvStorage (void);
+
+/* *****************************************************************************
+ * readNvStorage: copies length bytes starting at address into data. Returns
+ * false if the range is invalid or the storage is unavailable.
+ */
+bool
+readNvStorage (uint32_t address, uint32_t *data, uint32_t length);
+
+/* *****************************************************************************
+ * writeNvStorage: programs length bytes from data starting at address.
+ * Blocks until programming is complete. Returns false on failure.
+ */
+bool
+writeNvStorage (uint32_t address, const uint32_t *data, uint32_t length);
+
+#endif /* NVSTORAGE_H_ */
@@ -17,12 +17,63 @@
 #include "stdlib.h"
 
 
+#if PID_NUMERIC == PID_NUMERIC_FIXED
+/* *****************************************************************************
+ * saturate: limits a sum of fixed point values to the range of pidReal_t.
+ */
+static pidReal_t
+saturate (int64_t sum)
+{
+	if (sum > PID_MAX) {
+		return PID_MAX;
+	} else if (sum < PID_MIN) {
+		return PID_MIN;
+	}
+	return (pidReal_t)sum;
+}
+#endif
+
+
+/* *****************************************************************************
+ * integrateError: adds error * deltaT to the integrated error.
+ */
+static void
+integrateError (pidController_t *controller, pidReal_t error, pidReal_t deltaT)
+{
+#if PID_NUMERIC == PID_NUMERIC_FIXED
+	controller->errorIntegrated = saturate((int64_t)controller->errorIntegrated +
+			PID_MUL(error, deltaT));
+#else
+	controller->errorIntegrated += error * deltaT;
+#endif
+}
+
+
+/* *****************************************************************************
+ * pidControl: returns the sum of the three control terms.
+ */
+static pidReal_t
+pidControl (const pidController_t *controller, pidReal_t error,
+		pidReal_t errorDerivative)
+{
+#if PID_NUMERIC == PID_NUMERIC_FIXED
+	return saturate((int64_t)PID_MUL(error, controller->gainProportional) +
+			PID_MUL(controller->errorIntegrated, controller->gainIntegral) +
+			PID_MUL(errorDerivative, controller->gainDerivative));
+#else
+	return error * controller->gainProportional +
+			controller->errorIntegrated * controller->gainIntegral +
+			errorDerivative * controller->gainDerivative;
+#endif
+}
+
+
 /* *****************************************************************************
  * initPidController: initialises the given pidController instance by setting
  * all error members to zero, and storing the given control gains.
  */
 void
-initPidController (pidController_t *controller, double Kp, double Ki, double Kd) {
+initPidController (pidController_t *controller, pidReal_t Kp, pidReal_t Ki, pidReal_t Kd) {
 	controller->errorIntegrated = 0;
 	controller->errorPrevious = 0;
 	controller->gainProportional = Kp;
@@ -33,20 +84,173 @@ initPidController (pidController_t *controller, double Kp, double Ki, double Kd)
 
 /* *****************************************************************************
  * pidUpdate: adds the new error value to the controller. Calculates and returns
- * the new control value.
+ * the new control value. With PID_NUMERIC_FIXED the integrated error
+ * saturates rather than overflowing.
  */
-double
-pidUpdate (pidController_t *controller, double error, double deltaT) {
-	double errorDerivative;
-	double control;
+pidReal_t
+pidUpdate (pidController_t *controller, pidReal_t error, pidReal_t deltaT) {
+	pidReal_t errorDerivative;
+	pidReal_t control;
 
-	controller->errorIntegrated += error * deltaT;
-	errorDerivative = (error - controller->errorPrevious) / deltaT;
+	integrateError(controller, error, deltaT);
+	errorDerivative = PID_DIV(error - controller->errorPrevious, deltaT);
 
-	control = error * controller->gainProportional +
-			controller->errorIntegrated * controller->gainIntegral +
-			errorDerivative * controller->gainDerivative;
+	control = pidControl(controller, error, errorDerivative);
 
 	controller->errorPrevious = error;
 	return control;
 }
+
+
+/* *****************************************************************************
+ * initPidDiscrete: initialises the given discrete controller, with gains Kp,
+ * Ki and Kd, for updates every deltaT seconds. The derivative is low-pass
+ * filtered with time constant filterTime (zero for none). The output is
+ * limited to [outputMin, outputMax]; while it is, the integral term is pulled
+ * back towards the limit with time constant trackingTime (back-calculation
+ * anti-windup). trackingTime should be at least deltaT; zero (or negative)
+ * disables tracking, leaving the integral unbounded.
+ */
+void
+initPidDiscrete (pidDiscrete_t *controller, pidReal_t Kp, pidReal_t Ki, pidReal_t Kd,
+		pidReal_t filterTime, pidReal_t trackingTime, pidReal_t deltaT,
+		pidReal_t outputMin, pidReal_t outputMax) {
+	pidReal_t filterPeriod = filterTime + deltaT;
+
+	controller->integral = 0;
+	controller->derivative = 0;
+	controller->gainProportional = Kp;
+	controller->gainIntegral = PID_MUL(Ki, deltaT);
+	// Without an integral term there is nothing to wind up
+	controller->gainTracking = ((Ki != 0) && (trackingTime > 0)) ? PID_DIV(deltaT, trackingTime) : 0;
+	controller->derivativeDecay = PID_DIV(filterTime, filterPeriod);
+	controller->gainDerivative = PID_DIV(PID_MUL(Kd, deltaT), filterPeriod);
+	controller->outputMin = outputMin;
+	controller->outputMax = outputMax;
+}
+
+
+/* *****************************************************************************
+ * pidDiscreteUpdate: adds the new error value to the controller, with the
+ * derivative taken from measuredRate, the rate of change of the measured
+ * value. Returns the new control value, within the output limits.
+ */
+pidReal_t
+pidDiscreteUpdate (pidDiscrete_t *controller, pidReal_t error, pidReal_t measuredRate) {
+	pidReal_t unlimited;
+	pidReal_t control;
+
+#if PID_NUMERIC == PID_NUMERIC_FIXED
+	controller->integral = saturate((int64_t)controller->integral +
+			PID_MUL(controller->gainIntegral, error));
+#else
+	controller->integral += controller->gainIntegral * error;
+#endif
+
+	// Backward Euler low-pass of Kd * derivative, where the error derivative is
+	// -measuredRate with a constant setpoint
+	controller->derivative = PID_MUL(controller->derivativeDecay, controller->derivative) -
+			PID_MUL(controller->gainDerivative, measuredRate);
+
+#if PID_NUMERIC == PID_NUMERIC_FIXED
+	unlimited = saturate((int64_t)PID_MUL(controller->gainProportional, error) +
+			controller->integral + controller->derivative);
+#else
+	unlimited = controller->gainProportional * error + controller->integral +
+			controller->derivative;
+#endif
+
+	control = unlimited;
+	if (control > controller->outputMax) {
+		control = controller->outputMax;
+	} else if (control < controller->outputMin) {
+		control = controller->outputMin;
+	}
+
+	// Unwind the integral by the excess over the output limits
+#if PID_NUMERIC == PID_NUMERIC_FIXED
+	controller->integral = saturate((int64_t)controller->integral +
+			PID_MUL(controller->gainTracking, (int64_t)control - unlimited));
+#else
+	controller->integral += controller->gainTracking * (control - unlimited);
+#endif
+	return control;
+}
+
+
+/* *****************************************************************************
+ * initPidBatch: initialises the given batch for count controllers, which must
+ * not exceed PID_BATCH_MAX. Each controller must then be set with
+ * setPidBatchController.
+ */
+void
+initPidBatch (pidBatch_t *batch, uint32_t count) {
+	batch->count = (count > PID_BATCH_MAX) ? PID_BATCH_MAX : count;
+}
+
+
+/* *****************************************************************************
+ * setPidBatchController: sets controller index of the batch, and clears its
+ * state. Parameters are as for initPidDiscrete.
+ */
+void
+setPidBatchController (pidBatch_t *batch, uint32_t index, pidReal_t Kp, pidReal_t Ki,
+		pidReal_t Kd, pidReal_t filterTime, pidReal_t trackingTime, pidReal_t deltaT,
+		pidReal_t outputMin, pidReal_t outputMax) {
+	pidDiscrete_t controller;
+
+	// Coefficients are calculated as for a single controller
+	initPidDiscrete(&controller, Kp, Ki, Kd, filterTime, trackingTime, deltaT,
+			outputMin, outputMax);
+
+	batch->integral[index] = controller.integral;
+	batch->derivative[index] = controller.derivative;
+	batch->gainProportional[index] = controller.gainProportional;
+	batch->gainIntegral[index] = controller.gainIntegral;
+	batch->gainTracking[index] = controller.gainTracking;
+	batch->derivativeDecay[index] = controller.derivativeDecay;
+	batch->gainDerivative[index] = controller.gainDerivative;
+	batch->outputMin[index] = controller.outputMin;
+	batch->outputMax[index] = controller.outputMax;
+}
+
+
+/* *****************************************************************************
+ * pidBatchUpdate: as for pidDiscreteUpdate, for every controller of the batch.
+ * error and measuredRate hold one input per controller, and control receives
+ * one output per controller. The arrays must not overlap.
+ */
+void
+pidBatchUpdate (pidBatch_t *restrict batch, const pidReal_t *restrict error,
+		const pidReal_t *restrict measuredRate, pidReal_t *restrict control) {
+	uint32_t count = batch->count;
+	uint32_t i;
+
+	// Branch-free, with each array accessed once per controller
+	for (i = 0; i < count; i++) {
+#if PID_NUMERIC == PID_NUMERIC_FIXED
+		pidReal_t integral = saturate((int64_t)batch->integral[i] +
+				PID_MUL(batch->gainIntegral[i], error[i]));
+		pidReal_t derivative = PID_MUL(batch->derivativeDecay[i], batch->derivative[i]) -
+				PID_MUL(batch->gainDerivative[i], measuredRate[i]);
+		pidReal_t unlimited = saturate((int64_t)PID_MUL(batch->gainProportional[i], error[i]) +
+				integral + derivative);
+#else
+		pidReal_t integral = batch->integral[i] + batch->gainIntegral[i] * error[i];
+		pidReal_t derivative = batch->derivativeDecay[i] * batch->derivative[i] -
+				batch->gainDerivative[i] * measuredRate[i];
+		pidReal_t unlimited = batch->gainProportional[i] * error[i] + integral + derivative;
+#endif
+		pidReal_t limited = (unlimited > batch->outputMax[i]) ? batch->outputMax[i] : unlimited;
+		limited = (limited < batch->outputMin[i]) ? batch->outputMin[i] : limited;
+
+#if PID_NUMERIC == PID_NUMERIC_FIXED
+		batch->integral[i] = saturate((int64_t)integral +
+				PID_MUL(batch->gainTracking[i], (int64_t)limited - unlimited));
+#else
+		batch->integral[i] = integral + batch->gainTracking[i] * (limited - unlimited);
+#endif
+		batch->derivative[i] = derivative;
+		control[i] = limited;
+	}
+}
@@ -16,30 +16,155 @@
 
 #include <stdint.h>
 
+/* *****************************************************************************
+ * Number type, selected at build time. The FPU only supports single
+ * precision, so PID_NUMERIC_DOUBLE runs in software; it is kept as a
+ * reference for the others.
+ */
+#define PID_NUMERIC_DOUBLE 0
+#define PID_NUMERIC_FLOAT 1
+#define PID_NUMERIC_FIXED 2 // signed Q16.16, range +-32768
+#ifndef PID_NUMERIC
+#define PID_NUMERIC PID_NUMERIC_FLOAT
+#endif
+
+#if PID_NUMERIC == PID_NUMERIC_FIXED
+typedef int32_t pidReal_t;
+#define PID_FRAC_BITS 16
+#define PID_MAX INT32_MAX
+#define PID_MIN INT32_MIN
+// Compile time conversion of a real constant, rounded to nearest
+#define PID_CONST(x) ((pidReal_t)((x) * (1 << PID_FRAC_BITS) + (((x) < 0) ? -0.5 : 0.5)))
+#define PID_FROM_INT(i) ((pidReal_t)(i) * (1 << PID_FRAC_BITS))
+#define PID_TO_INT(x) ((int32_t)(x) / (1 << PID_FRAC_BITS)) // truncates, as a cast does
+#define PID_MUL(a, b) ((pidReal_t)(((int64_t)(a) * (b) + (1 << (PID_FRAC_BITS - 1))) >> PID_FRAC_BITS))
+#define PID_DIV(a, b) ((pidReal_t)(((int64_t)(a) << PID_FRAC_BITS) / (b)))
+#else
+#if PID_NUMERIC == PID_NUMERIC_DOUBLE
+typedef double pidReal_t;
+#else
+typedef float pidReal_t;
+#endif
+#define PID_CONST(x) ((pidReal_t)(x))
+#define PID_FROM_INT(i) ((pidReal_t)(i))
+#define PID_TO_INT(x) ((int32_t)(x))
+#define PID_MUL(a, b) ((a) * (b))
+#define PID_DIV(a, b) ((a) / (b))
+#endif
+// Integer i times a PID_CONST, without intermediate rounding
+#define PID_SCALE_INT(i, c) ((pidReal_t)(i) * (c))
+
 /* *****************************************************************************
  * Controller structure
  */
 typedef struct {
-	double errorIntegrated;
-	double errorPrevious;
-	double gainProportional;
-	double gainIntegral;
-	double gainDerivative;
+	pidReal_t errorIntegrated;
+	pidReal_t errorPrevious;
+	pidReal_t gainProportional;
+	pidReal_t gainIntegral;
+	pidReal_t gainDerivative;
 } pidController_t;
 
+/* *****************************************************************************
+ * Discrete controller structure. Gains are combined with the update period
+ * at initialisation, so an update needs no division.
+ */
+typedef struct {
+	pidReal_t integral;			// integral term, in output units
+	pidReal_t derivative;		// filtered derivative term, in output units
+	pidReal_t gainProportional;
+	pidReal_t gainIntegral;		// Ki * T
+	pidReal_t gainTracking;		// T / Tt, for anti-windup
+	pidReal_t derivativeDecay;	// Tf / (Tf + T)
+	pidReal_t gainDerivative;	// Kd / (Tf + T) * T
+	pidReal_t outputMin;
+	pidReal_t outputMax;
+} pidDiscrete_t;
+
+/* *****************************************************************************
+ * Batch of discrete controllers, updated together. Each member is kept in its
+ * own array (indexed by controller), so an update is one pass over contiguous
+ * arrays, which the compiler can vectorise.
+ */
+#ifndef PID_BATCH_MAX
+#define PID_BATCH_MAX 8
+#endif
+
+typedef struct {
+	uint32_t count;
+	pidReal_t integral[PID_BATCH_MAX];
+	pidReal_t derivative[PID_BATCH_MAX];
+	pidReal_t gainProportional[PID_BATCH_MAX];
+	pidReal_t gainIntegral[PID_BATCH_MAX];
+	pidReal_t gainTracking[PID_BATCH_MAX];
+	pidReal_t derivativeDecay[PID_BATCH_MAX];
+	pidReal_t gainDerivative[PID_BATCH_MAX];
+	pidReal_t outputMin[PID_BATCH_MAX];
+	pidReal_t outputMax[PID_BATCH_MAX];
+} pidBatch_t;
+
 /* *****************************************************************************
  * initPidController: initialises the given pidController instance by setting
  * all error members to zero, and storing the given control gains.
  */
 void
-initPidController (pidController_t *controller, double Kp, double Ki, double Kd);
+initPidController (pidController_t *controller, pidReal_t Kp, pidReal_t Ki, pidReal_t Kd);
 
 
 /* *****************************************************************************
  * pidUpdate: adds the new error value to the controller. Calculates and returns
- * the new control value.
+ * the new control value. With PID_NUMERIC_FIXED the integrated error
+ * saturates rather than overflowing.
+ */
+pidReal_t
+pidUpdate (pidController_t *controller, pidReal_t error, pidReal_t deltaT);
+
+/* *****************************************************************************
+ * initPidDiscrete: initialises the given discrete controller, with gains Kp,
+ * Ki and Kd, for updates every deltaT seconds. The derivative is low-pass
+ * filtered with time constant filterTime (zero for none). The output is
+ * limited to [outputMin, outputMax]; while it is, the integral term is pulled
+ * back towards the limit with time constant trackingTime (back-calculation
+ * anti-windup). trackingTime should be at least deltaT; zero (or negative)
+ * disables tracking, leaving the integral unbounded.
  */
-double
-pidUpdate (pidController_t *controller, double error, double deltaT);
+void
+initPidDiscrete (pidDiscrete_t *controller, pidReal_t Kp, pidReal_t Ki, pidReal_t Kd,
+		pidReal_t filterTime, pidReal_t trackingTime, pidReal_t deltaT,
+		pidReal_t outputMin, pidReal_t outputMax);
+
+/* *****************************************************************************
+ * pidDiscreteUpdate: adds the new error value to the controller, with the
+ * derivative taken from measuredRate, the rate of change of the measured
+ * value. Returns the new control value, within the output limits.
+ */
+pidReal_t
+pidDiscreteUpdate (pidDiscrete_t *controller, pidReal_t error, pidReal_t measuredRate);
+
+/* *****************************************************************************
+ * initPidBatch: initialises the given batch for count controllers, which must
+ * not exceed PID_BATCH_MAX. Each controller must then be set with
+ * setPidBatchController.
+ */
+void
+initPidBatch (pidBatch_t *batch, uint32_t count);
+
+/* *****************************************************************************
+ * setPidBatchController: sets controller index of the batch, and clears its
+ * state. Parameters are as for initPidDiscrete.
+ */
+void
+setPidBatchController (pidBatch_t *batch, uint32_t index, pidReal_t Kp, pidReal_t Ki,
+		pidReal_t Kd, pidReal_t filterTime, pidReal_t trackingTime, pidReal_t deltaT,
+		pidReal_t outputMin, pidReal_t outputMax);
+
+/* *****************************************************************************
+ * pidBatchUpdate: as for pidDiscreteUpdate, for every controller of the batch.
+ * error and measuredRate hold one input per controller, and control receives
+ * one output per controller. The arrays must not overlap.
+ */
+void
+pidBatchUpdate (pidBatch_t *restrict batch, const pidReal_t *restrict error,
+		const pidReal_t *restrict measuredRate, pidReal_t *restrict control);
 
 #endif /*PID_CONTROLLER_H_*/
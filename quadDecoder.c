@@ -0,0 +1,55 @@
+/* *****************************************************************************
+ * quadDecoder.c
+ *
+ * Table-driven quadrature decoding of two channels, A and B.
+ *
+ * Hangwen Hu and Marc Katzef
+ * Last modified:  16.10.2026
+ */
+
+#include "quadDecoder.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* *****************************************************************************
+ * Transition tables, indexed by (previous state << 2) | new state. Clockwise
+ * (B leading A) is 00 -> 01 -> 11 -> 10 -> 00.
+ */
+static const int8_t g_quadDelta[16] = {
+	 0, +1, -1,  0,		// from 00
+	-1,  0,  0, +1,		// from 01
+	+1,  0,  0, -1,		// from 10
+	 0, -1, +1,  0		// from 11
+};
+
+// Bit set for each transition in which both channels change
+#define QUAD_ILLEGAL_MASK 0x1248
+
+
+/* *****************************************************************************
+ * initQuadDecoder: sets the initial AB state, and clears the illegal
+ * transition count.
+ */
+void
+initQuadDecoder (quadDecoder_t *decoder, uint32_t state)
+{
+	decoder->state = state & 3;
+	decoder->illegalCount = 0;
+}
+
+
+/* *****************************************************************************
+ * quadDecoderUpdate: moves the decoder to the given AB state, and returns the
+ * resulting count change: +1 for clockwise, -1 for anticlockwise, or 0 if the
+ * state is unchanged or the transition is illegal.
+ */
+int32_t
+quadDecoderUpdate (quadDecoder_t *decoder, uint32_t state)
+{
+	uint32_t transition = (decoder->state << 2) | (state & 3);
+
+	decoder->illegalCount += (QUAD_ILLEGAL_MASK >> transition) & 1;
+	decoder->state = state & 3;
+	return g_quadDelta[transition];
+}
@@ -0,0 +1,53 @@
+#ifndef QUADDECODER_H_
+#define QUADDECODER_H_
+
+/* *****************************************************************************
+ * quadDecoder.h
+ *
+ * Table-driven quadrature decoding of two channels, A and B.
+ *
+ * Each update looks up the transition from the previous to the new AB state in
+ * a 16-entry table, giving a count change of +1 (clockwise), -1 or 0 without
+ * branching. Transitions where both channels change at once are illegal: the
+ * direction is unknown, so they are counted instead, as a measure of signal
+ * quality (e.g. edges missed at high rates).
+ *
+ * Hardware independent, so it may be exercised off-target with synthetic edge
+ * sequences.
+ *
+ * Hangwen Hu and Marc Katzef
+ * Last modified:  16.10.2026
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* *****************************************************************************
+ * QUAD_STATE: combines the channel levels (each 0 or 1) into an AB state.
+ */
+#define QUAD_STATE(a, b) ((((a) & 1) << 1) | ((b) & 1))
+
+/* *****************************************************************************
+ * Decoder structure
+ */
+typedef struct {
+	uint32_t state;						// previous AB state
+	volatile uint32_t illegalCount;		// transitions with both channels changed
+} quadDecoder_t;
+
+/* *****************************************************************************
+ * initQuadDecoder: sets the initial AB state, and clears the illegal
+ * transition count.
+ */
+void
+initQuadDecoder (quadDecoder_t *decoder, uint32_t state);
+
+/* *****************************************************************************
+ * quadDecoderUpdate: moves the decoder to the given AB state, and returns the
+ * resulting count change: +1 for clockwise, -1 for anticlockwise, or 0 if the
+ * state is unchanged or the transition is illegal.
+ */
+int32_t
+quadDecoderUpdate (quadDecoder_t *decoder, uint32_t state);
+
+#endif /* QUADDECODER_H_ */
@@ -0,0 +1,57 @@
+/* *****************************************************************************
+ * stateLatch.c
+ *
+ * Consistent flight state snapshots shared between interrupt handlers and the
+ * main loop, without masking interrupts.
+ *
+ * Hangwen Hu and Marc Katzef
+ * Last modified:  16.10.2026
+ */
+
+#include "stateLatch.h"
+
+#include <stdint.h>
+
+/* *****************************************************************************
+ * initStateLatch: sets both copies of the latch to initial.
+ */
+void
+initStateLatch (stateLatch_t *latch, const flightState_t *initial)
+{
+	latch->sequence = 0;
+	latch->copy[0] = *initial;
+	latch->copy[1] = *initial;
+}
+
+
+/* *****************************************************************************
+ * publishState: replaces the latched state with state. Must only be called by
+ * the latch's one writer.
+ */
+void
+publishState (stateLatch_t *latch, const flightState_t *state)
+{
+	latch->sequence++; // Readers use copy 1
+	latch->copy[0] = *state;
+	latch->sequence++; // Readers use copy 0
+	latch->copy[1] = *state;
+}
+
+
+/* *****************************************************************************
+ * readState: copies the most recently published state into state. Returns the
+ * sequence count of the copy, which advances by two on each publish, so a
+ * reader can tell whether the state has changed since its last read.
+ */
+uint32_t
+readState (const stateLatch_t *latch, flightState_t *state)
+{
+	uint32_t sequence;
+
+	do {
+		sequence = latch->sequence;
+		*state = latch->copy[sequence & 1];
+	} while (sequence != latch->sequence);
+
+	return sequence & ~1u; // Mid-publish, copy 1 is the previous state
+}
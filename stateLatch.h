@@ -0,0 +1,62 @@
+#ifndef STATELATCH_H_
+#define STATELATCH_H_
+
+/* *****************************************************************************
+ * stateLatch.h
+ *
+ * Consistent flight state snapshots shared between interrupt handlers and the
+ * main loop, without masking interrupts.
+ *
+ * Each latch has one writer, which keeps two copies of the state and a
+ * sequence count. While one copy is being written, readers are directed to the
+ * other, so a reader that preempts the writer reads a complete snapshot on its
+ * first attempt and never waits. A reader that is itself preempted by the
+ * writer sees the sequence change and reads again.
+ *
+ * Hangwen Hu and Marc Katzef
+ * Last modified:  16.10.2026
+ */
+
+#include <stdint.h>
+
+/* *****************************************************************************
+ * Flight state. Measurements and the targets they are controlled towards.
+ */
+typedef struct {
+	uint32_t timestamp;			// controller updates since start
+	int32_t altitude;			// percent
+	int32_t altitudeTenths;		// tenths of a percent
+	int32_t altitudeRate;		// tenths of a percent per second
+	int32_t yaw;				// encoder counts in [0, INTERRUPTS_PER_REV)
+	int32_t yawRate;			// centidegrees per second
+	int32_t targetAltitude;		// percent
+	int32_t targetYaw;			// encoder counts in [0, INTERRUPTS_PER_REV)
+} flightState_t;
+
+typedef struct {
+	volatile uint32_t sequence; // odd while copy 0 is being written
+	volatile flightState_t copy[2];
+} stateLatch_t;
+
+/* *****************************************************************************
+ * initStateLatch: sets both copies of the latch to initial.
+ */
+void
+initStateLatch (stateLatch_t *latch, const flightState_t *initial);
+
+/* *****************************************************************************
+ * publishState: replaces the latched state with state. Must only be called by
+ * the latch's one writer.
+ */
+void
+publishState (stateLatch_t *latch, const flightState_t *state);
+
+/* *****************************************************************************
+ * readState: copies the most recently published state into state. Returns the
+ * sequence count of the copy, which advances by two on each publish, so a
+ * reader can tell whether the state has changed since its last read.
+ */
+uint32_t
+readState (const stateLatch_t *latch, flightState_t *state);
+
+#endif /* STATELATCH_H_ */
@@ -0,0 +1,69 @@
+/* *****************************************************************************
+ * benchCircBufMean.c
+ *
+ * Host benchmark of circBufMean: the running sum against the previous full
+ * rescan through readCircBuf, across buffer sizes.
+ *
+ * Hangwen Hu and Marc Katzef
+ * Last modified:  16.10.2026
+ */
+
+#include "testUtil.h"
+#include "circBufT.h"
+
+#include <stdint.h>
+
+#define CALLS 200000
+
+/* *****************************************************************************
+ * rescanCircBufMean: the previous circBufMean, which reads every entry.
+ */
+static uint32_t
+rescanCircBufMean (circBuf_t *buffer)
+{
+	uint32_t bufferSize = buffer->size;
+	int64_t circBufSum = 0;
+	uint32_t i;
+
+	for (i = 0; i < bufferSize; i++) {
+		circBufSum += readCircBuf(buffer);
+	}
+	return (2 * circBufSum + bufferSize) / (2 * bufferSize);
+}
+
+
+int
+main (void)
+{
+	static const uint32_t sizes[] = {8, 25, 64, 256, 1024};
+	volatile uint32_t sink = 0;
+	circBuf_t buffer;
+	uint32_t s;
+	uint32_t i;
+
+	printf("%6s %12s %12s\n", "size", "rescan ns", "running ns");
+	for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+		initCircBuf(&buffer, sizes[s]);
+		for (i = 0; i < sizes[s]; i++) {
+			writeCircBuf(&buffer, 2000 + (i & 0xF));
+		}
+
+		double start = testSeconds();
+		for (i = 0; i < CALLS; i++) {
+			writeCircBuf(&buffer, 2000 + (i & 0xF));
+			sink += rescanCircBufMean(&buffer);
+		}
+		double rescan = testSeconds() - start;
+
+		start = testSeconds();
+		for (i = 0; i < CALLS; i++) {
+			writeCircBuf(&buffer, 2000 + (i & 0xF));
+			sink += circBufMean(&buffer);
+		}
+		double running = testSeconds() - start;
+
+		printf("%6u %12.1f %12.1f\n", sizes[s], rescan * 1e9 / CALLS, running * 1e9 / CALLS);
+		freeCircBuf(&buffer);
+	}
+	return 0;
+}
@@ -0,0 +1,71 @@
+/* *****************************************************************************
+ * benchDecimatingFilter.c
+ *
+ * Host benchmark of the altitude filter pipeline per input sample:
+ * cicDecimatorUpdate on every sample, and iirFilterUpdate on each decimated
+ * output, against each stage alone, with the altimeter's parameters.
+ *
+ * Hangwen Hu and Marc Katzef
+ * Last modified:  16.10.2026
+ */
+
+#include "testUtil.h"
+#include "decimatingFilter.h"
+#include "altimeter.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#define CALLS 4000000
+#define INPUTS 1024 // samples cycled through, so the compiler cannot fold them
+
+static int32_t g_inputs[INPUTS];
+
+
+int
+main (void)
+{
+	volatile int32_t sink = 0;
+	cicDecimator_t cic;
+	iirFilter_t filter;
+	int32_t decimated;
+	uint32_t i;
+
+	srand(15);
+	for (i = 0; i < INPUTS; i++) {
+		g_inputs[i] = (2000 + rand() % 64) << ALT_IIR_FRAC_BITS;
+	}
+
+	initCicDecimator(&cic, ALT_CIC_ORDER, ALT_CIC_DECIMATION_LOG2, g_inputs[0]);
+	initIirFilter(&filter, ALT_IIR_B0, ALT_IIR_B1, ALT_IIR_B2, ALT_IIR_A1, ALT_IIR_A2, g_inputs[0]);
+	double start = testSeconds();
+	for (i = 0; i < CALLS; i++) {
+		if (cicDecimatorUpdate(&cic, g_inputs[i % INPUTS], &decimated)) {
+			sink = iirFilterUpdate(&filter, decimated);
+		}
+	}
+	double pipeline = testSeconds() - start;
+
+	initCicDecimator(&cic, ALT_CIC_ORDER, ALT_CIC_DECIMATION_LOG2, g_inputs[0]);
+	start = testSeconds();
+	for (i = 0; i < CALLS; i++) {
+		if (cicDecimatorUpdate(&cic, g_inputs[i % INPUTS], &decimated)) {
+			sink = decimated;
+		}
+	}
+	double cicOnly = testSeconds() - start;
+
+	initIirFilter(&filter, ALT_IIR_B0, ALT_IIR_B1, ALT_IIR_B2, ALT_IIR_A1, ALT_IIR_A2, g_inputs[0]);
+	start = testSeconds();
+	for (i = 0; i < CALLS; i++) {
+		sink = iirFilterUpdate(&filter, g_inputs[i % INPUTS]);
+	}
+	double iirOnly = testSeconds() - start;
+
+	(void)sink;
+	printf("CIC order %u / %u then biquad: %6.2f ns per input sample\n", ALT_CIC_ORDER,
+			1u << ALT_CIC_DECIMATION_LOG2, pipeline * 1e9 / CALLS);
+	printf("cicDecimatorUpdate alone:      %6.2f ns per input sample\n", cicOnly * 1e9 / CALLS);
+	printf("iirFilterUpdate alone:         %6.2f ns per call\n", iirOnly * 1e9 / CALLS);
+	return 0;
+}
@@ -0,0 +1,83 @@
+/* *****************************************************************************
+ * benchMedianFilter.c
+ *
+ * Host benchmark of the per-sample cost of the sliding median
+ * (medianFilterUpdate and medianFilterValue) against the running-sum mean,
+ * across window sizes. Each sample is written to the window first.
+ *
+ * Hangwen Hu and Marc Katzef
+ * Last modified:  16.10.2026
+ */
+
+#include "testUtil.h"
+#include "circBufStatic.h"
+#include "medianFilter.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#define CALLS 2000000
+#define INPUTS 1024 // samples cycled through, so the compiler cannot fold them
+
+CIRCBUF_STATIC_DEFINE(U16, g_window3, 3);
+CIRCBUF_STATIC_DEFINE(U16, g_window5, 5);
+CIRCBUF_STATIC_DEFINE(U16, g_window7, 7);
+CIRCBUF_STATIC_DEFINE(U16, g_window9, 9);
+MEDIAN_FILTER_DEFINE(g_median3, 3);
+MEDIAN_FILTER_DEFINE(g_median5, 5);
+MEDIAN_FILTER_DEFINE(g_median7, 7);
+MEDIAN_FILTER_DEFINE(g_median9, 9);
+
+static uint16_t g_inputs[INPUTS];
+
+/* *****************************************************************************
+ * benchWindow: prints the time per sample of the median and of the mean for
+ * one window.
+ */
+static void
+benchWindow (circBufU16_t *window, medianFilter_t *median)
+{
+	volatile uint32_t sink = 0;
+	uint32_t i;
+
+	initCircBufU16(window);
+	initMedianFilter(median, window);
+
+	double start = testSeconds();
+	for (i = 0; i < CALLS; i++) {
+		writeCircBufU16(window, g_inputs[i % INPUTS]);
+		medianFilterUpdate(median);
+		sink += medianFilterValue(median);
+	}
+	double medianTime = testSeconds() - start;
+
+	start = testSeconds();
+	for (i = 0; i < CALLS; i++) {
+		writeCircBufU16(window, g_inputs[i % INPUTS]);
+		sink += circBufU16Mean(window);
+	}
+	double meanTime = testSeconds() - start;
+
+	(void)sink;
+	printf("%6u %12.1f %12.1f\n", window->mask + 1, medianTime * 1e9 / CALLS,
+			meanTime * 1e9 / CALLS);
+}
+
+
+int
+main (void)
+{
+	uint32_t i;
+
+	srand(8);
+	for (i = 0; i < INPUTS; i++) {
+		g_inputs[i] = rand() & 0xFFF;
+	}
+
+	printf("%6s %12s %12s\n", "size", "median ns", "mean ns");
+	benchWindow(&g_window3, &g_median3);
+	benchWindow(&g_window5, &g_median5);
+	benchWindow(&g_window7, &g_median7);
+	benchWindow(&g_window9, &g_median9);
+	return 0;
+}
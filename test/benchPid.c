@@ -0,0 +1,113 @@
+/* *****************************************************************************
+ * benchPid.c
+ *
+ * Host benchmark of pidController in the number type selected by PID_NUMERIC
+ * (the Makefile builds one program per type): one pidUpdate, then the
+ * throughput of pidBatchUpdate against N. Host times only compare the types
+ * and forms with each other; see the README for timing on the target.
+ *
+ * Hangwen Hu and Marc Katzef
+ * Last modified:  16.10.2026
+ */
+
+#include "testUtil.h"
+#include "pidController.h"
+
+#include <stdint.h>
+
+#define CALLS 2000000
+#define INPUTS 64 // inputs cycled through, so the compiler cannot fold them
+
+#if PID_NUMERIC == PID_NUMERIC_FIXED
+#define PID_NAME "fixed"
+#elif PID_NUMERIC == PID_NUMERIC_FLOAT
+#define PID_NAME "float"
+#else
+#define PID_NAME "double"
+#endif
+
+/* *****************************************************************************
+ * benchBatch: compares the throughput of pidBatchUpdate with a loop of
+ * pidDiscreteUpdate over an array of controllers, across batch sizes.
+ */
+static void
+benchBatch (const pidReal_t *inputError, const pidReal_t *inputRate)
+{
+	static const uint32_t sizes[] = {1, 4, 16, 64, 256, 1024};
+	static pidBatch_t batch;
+	static pidDiscrete_t single[PID_BATCH_MAX];
+	static pidReal_t error[PID_BATCH_MAX];
+	static pidReal_t rate[PID_BATCH_MAX];
+	static pidReal_t control[PID_BATCH_MAX];
+	uint32_t s;
+	uint32_t i;
+
+	for (i = 0; i < PID_BATCH_MAX; i++) {
+		error[i] = inputError[i % INPUTS];
+		rate[i] = inputRate[i % INPUTS];
+	}
+
+	printf("%-8s %6s %16s %16s\n", PID_NAME, "N", "batch M/s", "single M/s");
+	for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]) && sizes[s] <= PID_BATCH_MAX; s++) {
+		uint32_t count = sizes[s];
+		uint32_t rounds = CALLS / count;
+		uint32_t r;
+
+		initPidBatch(&batch, count);
+		for (i = 0; i < count; i++) {
+			setPidBatchController(&batch, i, PID_CONST(1.0), PID_CONST(0.5), PID_CONST(0.2),
+					PID_CONST(0.02), PID_CONST(0.6), PID_CONST(0.01), PID_FROM_INT(2),
+					PID_FROM_INT(98));
+			initPidDiscrete(&single[i], PID_CONST(1.0), PID_CONST(0.5), PID_CONST(0.2),
+					PID_CONST(0.02), PID_CONST(0.6), PID_CONST(0.01), PID_FROM_INT(2),
+					PID_FROM_INT(98));
+		}
+
+		double start = testSeconds();
+		for (r = 0; r < rounds; r++) {
+			pidBatchUpdate(&batch, error, rate, control);
+		}
+		double batched = testSeconds() - start;
+
+		start = testSeconds();
+		for (r = 0; r < rounds; r++) {
+			for (i = 0; i < count; i++) {
+				control[i] = pidDiscreteUpdate(&single[i], error[i], rate[i]);
+			}
+		}
+		double separate = testSeconds() - start;
+
+		printf("%-8s %6u %16.1f %16.1f\n", "", count, (double)rounds * count / batched / 1e6,
+				(double)rounds * count / separate / 1e6);
+	}
+}
+
+
+int
+main (void)
+{
+	pidReal_t tenth = PID_CONST(0.1);
+	pidReal_t deltaT = PID_CONST(0.01);
+	pidReal_t error[INPUTS];
+	pidReal_t rate[INPUTS];
+	volatile pidReal_t sink = 0;
+	pidController_t controller;
+	uint32_t i;
+
+	for (i = 0; i < INPUTS; i++) {
+		error[i] = PID_SCALE_INT((int32_t)(i * 37 % 200) - 100, tenth);
+		rate[i] = PID_SCALE_INT((int32_t)(i * 11 % 50) - 25, tenth);
+	}
+
+	initPidController(&controller, PID_CONST(1.0), PID_CONST(0.5), PID_CONST(0.2));
+	double start = testSeconds();
+	for (i = 0; i < CALLS; i++) {
+		sink = pidUpdate(&controller, error[i % INPUTS], deltaT);
+	}
+	double elapsed = testSeconds() - start;
+
+	(void)sink;
+	printf("%-8s pidUpdate %6.2f ns\n", PID_NAME, elapsed * 1e9 / CALLS);
+	benchBatch(error, rate);
+	return 0;
+}
@@ -0,0 +1,122 @@
+/* *****************************************************************************
+ * fakeNvStorage.c
+ *
+ * Host stand-in for nvStorage.c, backed by a file. See fakeNvStorage.h.
+ *
+ * Hangwen Hu and Marc Katzef
+ * Last modified:  16.10.2026
+ */
+
+#include "fakeNvStorage.h"
+#include "nvStorage.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/* *****************************************************************************
+ * Globals to module
+ */
+static const char *g_fakeNvPath = "build/fakeNvStorage.bin";
+static bool g_fakeNvReady = false;
+
+/* *****************************************************************************
+ * validNvRange: as for nvStorage.c, returns true if [address, address +
+ * length) is word aligned and lies within the storage.
+ */
+static bool
+validNvRange (uint32_t address, uint32_t length)
+{
+	return g_fakeNvReady && ((address & 3) == 0) && ((length & 3) == 0) &&
+			(address <= NV_STORAGE_SIZE) && (length <= NV_STORAGE_SIZE - address);
+}
+
+
+/* *****************************************************************************
+ * transferNvFile: reads (write false) or writes length bytes at address in the
+ * file. Returns false on any file error.
+ */
+static bool
+transferNvFile (uint32_t address, uint32_t *data, uint32_t length, bool write)
+{
+	FILE *file = fopen(g_fakeNvPath, write ? "r+b" : "rb");
+	bool done;
+
+	if (file == NULL) {
+		return false;
+	}
+	done = (fseek(file, address, SEEK_SET) == 0) &&
+			((write ? fwrite(data, 1, length, file) : fread(data, 1, length, file)) == length);
+	return (fclose(file) == 0) && done;
+}
+
+
+void
+fakeNvStorageUse (const char *path)
+{
+	g_fakeNvPath = path;
+	g_fakeNvReady = false;
+}
+
+
+void
+fakeNvStorageErase (void)
+{
+	uint32_t erased = FAKE_NV_ERASED;
+	FILE *file = fopen(g_fakeNvPath, "wb");
+	uint32_t i;
+
+	if (file == NULL) {
+		return;
+	}
+	for (i = 0; i < NV_STORAGE_SIZE / sizeof(erased); i++) {
+		fwrite(&erased, sizeof(erased), 1, file);
+	}
+	fclose(file);
+}
+
+
+/* *****************************************************************************
+ * initNvStorage: opens the file, creating it erased if it does not exist.
+ * Returns false if it cannot be used.
+ */
+bool
+initNvStorage (void)
+{
+	FILE *file = fopen(g_fakeNvPath, "rb");
+	uint32_t lastWord;
+
+	if (file == NULL) {
+		fakeNvStorageErase();
+	} else {
+		fclose(file);
+	}
+
+	// Usable only if the file covers the whole storage
+	g_fakeNvReady = transferNvFile(NV_STORAGE_SIZE - sizeof(lastWord), &lastWord,
+			sizeof(lastWord), false);
+	return g_fakeNvReady;
+}
+
+
+/* *****************************************************************************
+ * readNvStorage: copies length bytes starting at address into data. Returns
+ * false if the range is invalid or the storage is unavailable.
+ */
+bool
+readNvStorage (uint32_t address, uint32_t *data, uint32_t length)
+{
+	return validNvRange(address, length) && transferNvFile(address, data, length, false);
+}
+
+
+/* *****************************************************************************
+ * writeNvStorage: programs length bytes from data starting at address. Returns
+ * false on failure.
+ */
+bool
+writeNvStorage (uint32_t address, const uint32_t *data, uint32_t length)
+{
+	return validNvRange(address, length) &&
+			transferNvFile(address, (uint32_t *)data, length, true);
+}
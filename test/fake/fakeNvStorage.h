@@ -0,0 +1,32 @@
+#ifndef FAKENVSTORAGE_H_
+#define FAKENVSTORAGE_H_
+
+/* *****************************************************************************
+ * fakeNvStorage.h
+ *
+ * Host stand-in for nvStorage.c, keeping the storage in a file so that a
+ * record survives a simulated restart. Implements nvStorage.h; the functions
+ * here let the tests choose and inspect the file.
+ *
+ * Hangwen Hu and Marc Katzef
+ * Last modified:  16.10.2026
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define FAKE_NV_ERASED 0xFFFFFFFF // content of an erased EEPROM word
+
+/* *****************************************************************************
+ * fakeNvStorageUse: makes path the file behind the storage. It is created
+ * erased (every word FAKE_NV_ERASED) by initNvStorage if it does not exist.
+ * Until initNvStorage is called again, reads and writes fail.
+ */
+void fakeNvStorageUse (const char *path);
+
+/* *****************************************************************************
+ * fakeNvStorageErase: erases the whole file, as for a new device.
+ */
+void fakeNvStorageErase (void);
+
+#endif /* FAKENVSTORAGE_H_ */
@@ -0,0 +1,829 @@
+/* *****************************************************************************
+ * fakeTiva.c
+ *
+ * Host stand-in for the parts of TivaWare used by the modules under test.
+ * See fakeTiva.h.
+ *
+ * Hangwen Hu and Marc Katzef
+ * Last modified:  16.10.2026
+ */
+
+#include "fakeTiva.h"
+
+#include <stddef.h>
+#include <string.h>
+
+/* *****************************************************************************
+ * Globals to module
+ */
+fakeAdcSequencer_t g_fakeAdcSequencers[FAKE_ADC_SEQUENCERS];
+fakeAdcComparator_t g_fakeAdcComparators[FAKE_ADC_COMPARATORS];
+uint32_t g_fakeAdcOversample = 1;
+fakeTimer_t g_fakeTimers[FAKE_TIMERS];
+fakeDmaTransfer_t g_fakeDmaTransfers[2];
+uint32_t g_fakeDmaLost;
+fakeQei_t g_fakeQei;
+
+static uint32_t g_fakeAdcLevel;
+static uint32_t (*g_fakeAdcSource)(void);
+static uint32_t g_fakeAdcDrop;
+static uint32_t g_fakeComparatorStatus;
+static bool g_fakeIntMasterDisabled;
+static uint32_t g_fakeAdcIntEnabledEx;
+static uint32_t g_fakeAdcIntPendingEx;
+static bool g_fakeDmaEnabled;
+static uint32_t g_fakeDmaSelect; // index of the active transfer
+
+typedef struct {
+	uint8_t levels;
+	uint8_t intEnabled;
+	uint8_t intStatus;			// raw status, set on each change of level
+	void (*handler)(void);
+} fakeGpioPort_t;
+
+static fakeGpioPort_t g_fakeGpioPorts[6]; // ports A to F
+
+#define FAKE_REGISTERS 16
+static uint32_t g_fakeRegisterAddress[FAKE_REGISTERS];
+static uint32_t g_fakeRegisterValue[FAKE_REGISTERS];
+static uint32_t g_fakeRegisterCount;
+
+static void fakeDeliverInterrupts (void);
+
+
+/* *****************************************************************************
+ * Register access
+ */
+volatile uint32_t *
+fakeRegister (uint32_t address)
+{
+	uint32_t i;
+
+	for (i = 0; i < g_fakeRegisterCount; i++) {
+		if (g_fakeRegisterAddress[i] == address)
+			return &g_fakeRegisterValue[i];
+	}
+	if (g_fakeRegisterCount == FAKE_REGISTERS) {
+		i = 0; // Out of registers: alias the first rather than fail
+	} else {
+		i = g_fakeRegisterCount++;
+	}
+	g_fakeRegisterAddress[i] = address;
+	g_fakeRegisterValue[i] = 0;
+	return &g_fakeRegisterValue[i];
+}
+
+
+/* *****************************************************************************
+ * System control and interrupts
+ */
+void
+SysCtlPeripheralEnable (uint32_t peripheral)
+{
+}
+
+
+uint32_t
+SysCtlClockGet (void)
+{
+	return FAKE_CLOCK_HZ;
+}
+
+
+void
+IntEnable (uint32_t interrupt)
+{
+}
+
+
+bool
+IntMasterDisable (void)
+{
+	bool wasDisabled = g_fakeIntMasterDisabled;
+
+	g_fakeIntMasterDisabled = true;
+	return wasDisabled;
+}
+
+
+bool
+IntMasterEnable (void)
+{
+	bool wasDisabled = g_fakeIntMasterDisabled;
+
+	g_fakeIntMasterDisabled = false;
+	fakeDeliverInterrupts();
+	return wasDisabled;
+}
+
+
+bool
+fakeIntMasterDisabled_p (void)
+{
+	return g_fakeIntMasterDisabled;
+}
+
+
+/* *****************************************************************************
+ * fakeDeliverInterrupts: calls the handlers of pending, enabled interrupts,
+ * unless interrupts are disabled.
+ */
+static void
+fakeDeliverInterrupts (void)
+{
+	void (*handler)(void);
+	uint32_t i;
+
+	if (g_fakeIntMasterDisabled) {
+		return;
+	}
+
+	handler = g_fakeAdcSequencers[3].handler;
+	if ((g_fakeAdcIntPendingEx & g_fakeAdcIntEnabledEx) && handler) {
+		handler();
+	}
+
+	for (i = 0; i < FAKE_ADC_SEQUENCERS; i++) {
+		handler = g_fakeAdcSequencers[i].handler;
+		if (g_fakeComparatorStatus && g_fakeAdcSequencers[i].comparatorInt && handler) {
+			handler();
+		}
+	}
+	if ((g_fakeQei.intStatus & g_fakeQei.intEnabled) && g_fakeQei.handler) {
+		g_fakeQei.handler();
+	}
+	for (i = 0; i < sizeof(g_fakeGpioPorts) / sizeof(g_fakeGpioPorts[0]); i++) {
+		handler = g_fakeGpioPorts[i].handler;
+		if ((g_fakeGpioPorts[i].intStatus & g_fakeGpioPorts[i].intEnabled) && handler) {
+			handler();
+		}
+	}
+}
+
+
+/* *****************************************************************************
+ * GPIO
+ */
+static fakeGpioPort_t *
+fakeGpioPort (uint32_t port)
+{
+	switch (port) {
+	case GPIO_PORTA_BASE: return &g_fakeGpioPorts[0];
+	case GPIO_PORTB_BASE: return &g_fakeGpioPorts[1];
+	case GPIO_PORTC_BASE: return &g_fakeGpioPorts[2];
+	case GPIO_PORTD_BASE: return &g_fakeGpioPorts[3];
+	case GPIO_PORTE_BASE: return &g_fakeGpioPorts[4];
+	default: return &g_fakeGpioPorts[5];
+	}
+}
+
+
+void
+fakeGpioSet (uint32_t port, uint8_t pins, bool high)
+{
+	fakeGpioPort_t *fake = fakeGpioPort(port);
+	uint8_t levels = high ? (fake->levels | pins) : (fake->levels & ~pins);
+
+	fake->intStatus |= levels ^ fake->levels;
+	fake->levels = levels;
+	fakeDeliverInterrupts();
+}
+
+
+void
+GPIOPinTypeADC (uint32_t port, uint8_t pins)
+{
+}
+
+
+void
+GPIOPinTypeQEI (uint32_t port, uint8_t pins)
+{
+}
+
+
+void
+GPIOPinConfigure (uint32_t pinConfig)
+{
+}
+
+
+void
+GPIOPadConfigSet (uint32_t port, uint8_t pins, uint32_t strength, uint32_t padType)
+{
+}
+
+
+int32_t
+GPIOPinRead (uint32_t port, uint8_t pins)
+{
+	return fakeGpioPort(port)->levels & pins;
+}
+
+
+void
+GPIOPinTypeGPIOInput (uint32_t port, uint8_t pins)
+{
+}
+
+
+void
+GPIOIntRegister (uint32_t port, void (*handler)(void))
+{
+	fakeGpioPort(port)->handler = handler;
+}
+
+
+void
+GPIOIntTypeSet (uint32_t port, uint8_t pins, uint32_t intType)
+{
+}
+
+
+void
+GPIOIntEnable (uint32_t port, uint32_t flags)
+{
+	fakeGpioPort(port)->intEnabled |= flags;
+	fakeDeliverInterrupts();
+}
+
+
+void
+GPIOIntDisable (uint32_t port, uint32_t flags)
+{
+	fakeGpioPort(port)->intEnabled &= ~flags;
+}
+
+
+void
+GPIOIntClear (uint32_t port, uint32_t flags)
+{
+	fakeGpioPort(port)->intStatus &= ~flags;
+}
+
+
+/* *****************************************************************************
+ * ADC
+ */
+/* *****************************************************************************
+ * fakeAdcCompare: runs one conversion of each comparator step of the
+ * continuous sequencers. Returns the interrupts raised.
+ */
+static uint32_t
+fakeAdcCompare (void)
+{
+	uint32_t raised = 0;
+	uint32_t i;
+	uint32_t step;
+
+	for (i = 0; i < FAKE_ADC_SEQUENCERS; i++) {
+		fakeAdcSequencer_t *sequencer = &g_fakeAdcSequencers[i];
+
+		if (!sequencer->enabled || sequencer->trigger != ADC_TRIGGER_ALWAYS) {
+			continue;
+		}
+		for (step = 0; step < sequencer->stepCount; step++) {
+			uint32_t comp;
+			fakeAdcComparator_t *comparator;
+			bool inBand;
+
+			if ((sequencer->steps[step] & ADC_CTL_CMP0) != ADC_CTL_CMP0) {
+				continue;
+			}
+			comp = (sequencer->steps[step] >> 16) & 0x7;
+			comparator = &g_fakeAdcComparators[comp];
+			if (comparator->config == ADC_COMP_INT_LOW_ONCE) {
+				inBand = g_fakeAdcLevel < comparator->low;
+			} else if (comparator->config == ADC_COMP_INT_HIGH_ONCE) {
+				inBand = g_fakeAdcLevel >= comparator->high;
+			} else {
+				continue;
+			}
+
+			if (inBand && comparator->armed) {
+				comparator->armed = false;
+				raised |= 1 << comp;
+			} else if (!inBand) {
+				comparator->armed = true;
+			}
+		}
+	}
+	return raised;
+}
+
+
+void
+fakeAdcSetLevel (uint32_t level)
+{
+	uint32_t round;
+	uint32_t raised;
+
+	g_fakeAdcLevel = level;
+
+	// Each round stands for a conversion, after any handler has re-armed
+	for (round = 0; round < 4; round++) {
+		raised = fakeAdcCompare();
+		if (!raised) {
+			break;
+		}
+		g_fakeComparatorStatus |= raised;
+		fakeDeliverInterrupts();
+	}
+}
+
+
+void
+fakeAdcSetSource (uint32_t (*source)(void))
+{
+	g_fakeAdcSource = source;
+}
+
+
+void
+fakeAdcDropNext (uint32_t count)
+{
+	g_fakeAdcDrop = count;
+}
+
+
+/* *****************************************************************************
+ * fakeAdcConvert: returns one step result, averaged as configured.
+ */
+static uint32_t
+fakeAdcConvert (void)
+{
+	uint32_t sum = 0;
+	uint32_t i;
+
+	for (i = 0; i < g_fakeAdcOversample; i++) {
+		sum += g_fakeAdcSource ? g_fakeAdcSource() : g_fakeAdcLevel;
+	}
+	return sum / g_fakeAdcOversample;
+}
+
+
+void
+ADCSequenceConfigure (uint32_t base, uint32_t sequence, uint32_t trigger, uint32_t priority)
+{
+	fakeAdcSequencer_t *sequencer = &g_fakeAdcSequencers[sequence];
+
+	memset(sequencer, 0, offsetof(fakeAdcSequencer_t, handler));
+	sequencer->trigger = trigger;
+}
+
+
+void
+ADCSequenceStepConfigure (uint32_t base, uint32_t sequence, uint32_t step, uint32_t config)
+{
+	fakeAdcSequencer_t *sequencer = &g_fakeAdcSequencers[sequence];
+
+	sequencer->steps[step] = config;
+	if (config & ADC_CTL_END) {
+		sequencer->stepCount = step + 1;
+	}
+}
+
+
+void
+ADCSequenceEnable (uint32_t base, uint32_t sequence)
+{
+	g_fakeAdcSequencers[sequence].enabled = true;
+}
+
+
+void
+ADCHardwareOversampleConfigure (uint32_t base, uint32_t factor)
+{
+	g_fakeAdcOversample = factor ? factor : 1;
+}
+
+
+void
+ADCProcessorTrigger (uint32_t base, uint32_t sequence)
+{
+	fakeAdcSequencer_t *sequencer = &g_fakeAdcSequencers[sequence];
+	uint32_t i;
+
+	sequencer->triggers++;
+	if (!sequencer->enabled) {
+		return;
+	}
+	for (i = 0; i < sequencer->stepCount && sequencer->fifoCount < FAKE_ADC_STEPS; i++) {
+		sequencer->fifo[sequencer->fifoCount++] = fakeAdcConvert();
+	}
+	if (g_fakeAdcDrop) {
+		sequencer->fifoCount -= (g_fakeAdcDrop < sequencer->fifoCount) ? g_fakeAdcDrop : sequencer->fifoCount;
+		g_fakeAdcDrop = 0;
+	}
+	sequencer->intPending = true;
+}
+
+
+uint32_t
+ADCIntStatus (uint32_t base, uint32_t sequence, bool masked)
+{
+	return g_fakeAdcSequencers[sequence].intPending;
+}
+
+
+void
+ADCIntClear (uint32_t base, uint32_t sequence)
+{
+	g_fakeAdcSequencers[sequence].intPending = false;
+}
+
+
+int32_t
+ADCSequenceDataGet (uint32_t base, uint32_t sequence, uint32_t *buffer)
+{
+	fakeAdcSequencer_t *sequencer = &g_fakeAdcSequencers[sequence];
+	int32_t count = sequencer->fifoCount;
+
+	memcpy(buffer, sequencer->fifo, count * sizeof(buffer[0]));
+	sequencer->fifoCount = 0;
+	return count;
+}
+
+
+void
+ADCIntRegister (uint32_t base, uint32_t sequence, void (*handler)(void))
+{
+	g_fakeAdcSequencers[sequence].handler = handler;
+}
+
+
+void
+ADCIntEnableEx (uint32_t base, uint32_t flags)
+{
+	g_fakeAdcIntEnabledEx |= flags;
+}
+
+
+void
+ADCIntClearEx (uint32_t base, uint32_t flags)
+{
+	g_fakeAdcIntPendingEx &= ~flags;
+}
+
+
+void
+ADCSequenceDMAEnable (uint32_t base, uint32_t sequence)
+{
+	g_fakeAdcSequencers[sequence].dma = true;
+}
+
+
+/* *****************************************************************************
+ * ADC digital comparators
+ */
+void
+ADCComparatorConfigure (uint32_t base, uint32_t comp, uint32_t config)
+{
+	g_fakeAdcComparators[comp].config = config;
+}
+
+
+void
+ADCComparatorRegionSet (uint32_t base, uint32_t comp, uint32_t low, uint32_t high)
+{
+	g_fakeAdcComparators[comp].low = low;
+	g_fakeAdcComparators[comp].high = high;
+}
+
+
+void
+ADCComparatorReset (uint32_t base, uint32_t comp, bool trigger, bool interrupt)
+{
+	if (interrupt) {
+		g_fakeAdcComparators[comp].armed = true;
+	}
+}
+
+
+void
+ADCComparatorIntEnable (uint32_t base, uint32_t sequence)
+{
+	g_fakeAdcSequencers[sequence].comparatorInt = true;
+}
+
+
+uint32_t
+ADCComparatorIntStatus (uint32_t base)
+{
+	return g_fakeComparatorStatus;
+}
+
+
+void
+ADCComparatorIntClear (uint32_t base, uint32_t status)
+{
+	g_fakeComparatorStatus &= ~status;
+}
+
+
+/* *****************************************************************************
+ * Timers
+ */
+void
+TimerConfigure (uint32_t base, uint32_t config)
+{
+}
+
+
+void
+TimerLoadSet (uint32_t base, uint32_t timer, uint32_t value)
+{
+	FAKE_TIMER(base)->load = value;
+}
+
+
+void
+TimerControlTrigger (uint32_t base, uint32_t timer, bool enable)
+{
+	FAKE_TIMER(base)->trigger = enable;
+}
+
+
+void
+TimerEnable (uint32_t base, uint32_t timer)
+{
+	fakeTimer_t *fake = FAKE_TIMER(base);
+
+	fake->enabled = true;
+	fake->value = fake->load;
+}
+
+
+uint32_t
+TimerValueGet (uint32_t base, uint32_t timer)
+{
+	return FAKE_TIMER(base)->value;
+}
+
+
+void
+fakeTimerAdvance (uint32_t base, uint32_t ticks)
+{
+	fakeTimer_t *fake = FAKE_TIMER(base);
+	uint64_t period = (uint64_t)fake->load + 1;
+
+	if (fake->enabled) {
+		ticks %= period;
+		fake->value = (ticks <= fake->value) ? fake->value - ticks
+				: (uint32_t)(fake->value + period - ticks);
+	}
+}
+
+
+/* *****************************************************************************
+ * uDMA
+ */
+void
+uDMAEnable (void)
+{
+}
+
+
+void
+uDMAControlBaseSet (void *controlTable)
+{
+}
+
+
+void
+uDMAChannelAttributeDisable (uint32_t channel, uint32_t attributes)
+{
+}
+
+
+void
+uDMAChannelControlSet (uint32_t channelSelect, uint32_t control)
+{
+}
+
+
+void
+uDMAChannelTransferSet (uint32_t channelSelect, uint32_t mode, void *source, void *dest,
+		uint32_t size)
+{
+	fakeDmaTransfer_t *transfer = &g_fakeDmaTransfers[(channelSelect & UDMA_ALT_SELECT) ? 1 : 0];
+
+	transfer->mode = mode;
+	transfer->dest = dest;
+	transfer->size = size;
+	transfer->done = 0;
+}
+
+
+void
+uDMAChannelEnable (uint32_t channel)
+{
+	g_fakeDmaEnabled = true;
+}
+
+
+bool
+uDMAChannelIsEnabled (uint32_t channel)
+{
+	return g_fakeDmaEnabled;
+}
+
+
+uint32_t
+uDMAChannelModeGet (uint32_t channelSelect)
+{
+	return g_fakeDmaTransfers[(channelSelect & UDMA_ALT_SELECT) ? 1 : 0].mode;
+}
+
+
+void
+fakeTimerTick (void)
+{
+	fakeAdcSequencer_t *sequencer = &g_fakeAdcSequencers[3];
+	fakeDmaTransfer_t *transfer = &g_fakeDmaTransfers[g_fakeDmaSelect];
+	fakeTimer_t *timer = FAKE_TIMER(TIMER1_BASE);
+
+	if (!timer->enabled || !timer->trigger || !sequencer->enabled
+			|| sequencer->trigger != ADC_TRIGGER_TIMER || !sequencer->dma) {
+		return;
+	}
+	if (!g_fakeDmaEnabled || transfer->mode == UDMA_MODE_STOP) {
+		g_fakeDmaLost++;
+		return;
+	}
+
+	transfer->dest[transfer->done++] = fakeAdcConvert();
+	if (transfer->done == transfer->size) {
+		transfer->mode = UDMA_MODE_STOP;
+		g_fakeAdcIntPendingEx |= ADC_INT_DMA_SS3;
+		g_fakeDmaSelect ^= 1;
+		if (g_fakeDmaTransfers[g_fakeDmaSelect].mode == UDMA_MODE_STOP) {
+			g_fakeDmaEnabled = false;
+		}
+		fakeDeliverInterrupts();
+	}
+}
+
+
+/* *****************************************************************************
+ * QEI
+ */
+void
+QEIEnable (uint32_t base)
+{
+	g_fakeQei.enabled = true;
+}
+
+
+void
+QEIDisable (uint32_t base)
+{
+	g_fakeQei.enabled = false;
+}
+
+
+void
+QEIConfigure (uint32_t base, uint32_t config, uint32_t maxPosition)
+{
+	HWREG(base + QEI_O_CTL) = config;
+	g_fakeQei.maxPosition = maxPosition;
+}
+
+
+uint32_t
+QEIPositionGet (uint32_t base)
+{
+	return g_fakeQei.position;
+}
+
+
+void
+QEIPositionSet (uint32_t base, uint32_t position)
+{
+	g_fakeQei.position = position;
+}
+
+
+int32_t
+QEIDirectionGet (uint32_t base)
+{
+	return g_fakeQei.direction;
+}
+
+
+void
+QEIVelocityConfigure (uint32_t base, uint32_t preDiv, uint32_t period)
+{
+	g_fakeQei.velocityPeriod = period;
+}
+
+
+void
+QEIVelocityEnable (uint32_t base)
+{
+}
+
+
+uint32_t
+QEIVelocityGet (uint32_t base)
+{
+	return g_fakeQei.velocity;
+}
+
+
+void
+QEIIntRegister (uint32_t base, void (*handler)(void))
+{
+	g_fakeQei.handler = handler;
+}
+
+
+void
+QEIIntEnable (uint32_t base, uint32_t flags)
+{
+	g_fakeQei.intEnabled |= flags;
+}
+
+
+void
+QEIIntDisable (uint32_t base, uint32_t flags)
+{
+	g_fakeQei.intEnabled &= ~flags;
+}
+
+
+uint32_t
+QEIIntStatus (uint32_t base, bool masked)
+{
+	return masked ? (g_fakeQei.intStatus & g_fakeQei.intEnabled) : g_fakeQei.intStatus;
+}
+
+
+void
+QEIIntClear (uint32_t base, uint32_t flags)
+{
+	g_fakeQei.intStatus &= ~flags;
+}
+
+
+/* *****************************************************************************
+ * fakeQeiRaise: sets an interrupt status flag and delivers it if enabled.
+ */
+static void
+fakeQeiRaise (uint32_t flag)
+{
+	g_fakeQei.intStatus |= flag;
+	fakeDeliverInterrupts();
+}
+
+
+void
+fakeQeiStep (int32_t edges)
+{
+	int32_t step = (edges > 0) ? 1 : -1;
+
+	if (!g_fakeQei.enabled) {
+		return;
+	}
+	while (edges != 0) {
+		if ((step > 0) && (g_fakeQei.position == g_fakeQei.maxPosition)) {
+			g_fakeQei.position = 0;
+		} else if ((step < 0) && (g_fakeQei.position == 0)) {
+			g_fakeQei.position = g_fakeQei.maxPosition;
+		} else {
+			g_fakeQei.position += step;
+		}
+		g_fakeQei.direction = step;
+		g_fakeQei.velocityEdges++;
+		edges -= step;
+	}
+}
+
+
+void
+fakeQeiIndex (void)
+{
+	if (!g_fakeQei.enabled) {
+		return;
+	}
+	if (HWREG(QEI1_BASE + QEI_O_CTL) & QEI_CTL_RESMODE) {
+		g_fakeQei.position = 0;
+	}
+	fakeQeiRaise(QEI_INTINDEX);
+}
+
+
+void
+fakeQeiVelocityPeriod (void)
+{
+	g_fakeQei.velocity = g_fakeQei.velocityEdges;
+	g_fakeQei.velocityEdges = 0;
+	fakeQeiRaise(QEI_INTTIMER);
+}
+
+
+void
+fakeQeiPhaseError (void)
+{
+	fakeQeiRaise(QEI_INTERROR);
+}
@@ -0,0 +1,381 @@
+#ifndef FAKETIVA_H_
+#define FAKETIVA_H_
+
+/* *****************************************************************************
+ * fakeTiva.h
+ *
+ * Host stand-in for the parts of TivaWare used by the modules under test.
+ * Every inc/ and driverlib/ header in this folder includes this file, so the
+ * modules compile unchanged. Peripheral calls act on a simple model of the
+ * hardware, which the tests drive and inspect through the fake* functions.
+ *
+ * Hangwen Hu and Marc Katzef
+ * Last modified:  16.10.2026
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* *****************************************************************************
+ * Register access and memory map
+ * Direct register accesses go to a small fake register file, keyed by address.
+ */
+#define HWREG(x) (*fakeRegister(x))
+
+volatile uint32_t *fakeRegister (uint32_t address);
+
+#define GPIO_PORTA_BASE 0x40004000
+#define GPIO_PORTB_BASE 0x40005000
+#define GPIO_PORTC_BASE 0x40006000
+#define GPIO_PORTD_BASE 0x40007000
+#define GPIO_PORTE_BASE 0x40024000
+#define GPIO_PORTF_BASE 0x40025000
+#define ADC0_BASE 0x40038000
+#define QEI1_BASE 0x4002D000
+
+#define ADC_O_SSFIFO3 0x000000A8
+
+/* *****************************************************************************
+ * GPIO
+ */
+#define GPIO_PIN_0 0x01
+#define GPIO_PIN_1 0x02
+#define GPIO_PIN_2 0x04
+#define GPIO_PIN_3 0x08
+#define GPIO_PIN_4 0x10
+#define GPIO_PIN_5 0x20
+#define GPIO_PIN_6 0x40
+#define GPIO_PIN_7 0x80
+
+#define GPIO_BOTH_EDGES 0x00000001
+
+#define GPIO_STRENGTH_2MA 0x00000001
+#define GPIO_PIN_TYPE_STD_WPU 0x0000000A
+#define GPIO_PIN_TYPE_STD_WPD 0x0000000C
+
+#define GPIO_PC4_IDX1 0x00021006
+#define GPIO_PC5_PHA1 0x00021406
+#define GPIO_PC6_PHB1 0x00021806
+
+void GPIOPinTypeADC (uint32_t port, uint8_t pins);
+void GPIOPinTypeQEI (uint32_t port, uint8_t pins);
+void GPIOPinConfigure (uint32_t pinConfig);
+void GPIOPadConfigSet (uint32_t port, uint8_t pins, uint32_t strength, uint32_t padType);
+int32_t GPIOPinRead (uint32_t port, uint8_t pins);
+void GPIOPinTypeGPIOInput (uint32_t port, uint8_t pins);
+void GPIOIntRegister (uint32_t port, void (*handler)(void));
+void GPIOIntTypeSet (uint32_t port, uint8_t pins, uint32_t intType);
+void GPIOIntEnable (uint32_t port, uint32_t flags);
+void GPIOIntDisable (uint32_t port, uint32_t flags);
+void GPIOIntClear (uint32_t port, uint32_t flags);
+
+/* *****************************************************************************
+ * fakeGpioSet: drives the given pins of a port (GPIO_PORTA_BASE to
+ * GPIO_PORTF_BASE) high or low. Every change of level raises the pin's raw
+ * interrupt status (only GPIO_BOTH_EDGES is modelled), whether or not its
+ * interrupt is enabled, and the port handler is called if it is.
+ */
+void fakeGpioSet (uint32_t port, uint8_t pins, bool high);
+
+/* *****************************************************************************
+ * System control and interrupts
+ */
+#define FAKE_CLOCK_HZ 20000000
+
+#define SYSCTL_PERIPH_ADC0 0xf0003800
+#define SYSCTL_PERIPH_GPIOE 0xf0000804
+#define SYSCTL_PERIPH_TIMER1 0xf0000401
+#define SYSCTL_PERIPH_TIMER2 0xf0000402
+#define SYSCTL_PERIPH_GPIOB 0xf0000801
+#define SYSCTL_PERIPH_UDMA 0xf0000c00
+#define SYSCTL_PERIPH_GPIOC 0xf0000802
+#define SYSCTL_PERIPH_QEI1 0xf0004401
+
+void SysCtlPeripheralEnable (uint32_t peripheral);
+uint32_t SysCtlClockGet (void);
+
+#define INT_GPIOB 17
+#define INT_GPIOC 18
+
+void IntEnable (uint32_t interrupt);
+bool IntMasterDisable (void);
+bool IntMasterEnable (void);
+
+/* *****************************************************************************
+ * fakeIntMasterDisabled_p: returns true while IntMasterDisable holds back the
+ * fake interrupts. Interrupts raised meanwhile are delivered by
+ * IntMasterEnable, as on the processor.
+ */
+bool fakeIntMasterDisabled_p (void);
+
+#define ASSERT(expr)
+
+/* *****************************************************************************
+ * ADC sequencers and digital comparators
+ */
+#define ADC_TRIGGER_PROCESSOR 0x00000000
+#define ADC_TRIGGER_TIMER 0x00000005
+#define ADC_TRIGGER_ALWAYS 0x0000000F
+
+#define ADC_CTL_CH9 0x00000009
+#define ADC_CTL_END 0x00000020
+#define ADC_CTL_IE 0x00000040
+#define ADC_CTL_CMP0 0x00080000
+#define ADC_CTL_CMP1 0x00090000
+
+#define ADC_INT_DMA_SS3 0x00000800
+
+#define ADC_COMP_INT_NONE 0x00000003
+#define ADC_COMP_INT_LOW_ONCE 0x00000004
+#define ADC_COMP_INT_HIGH_ONCE 0x0000001C
+
+void ADCSequenceConfigure (uint32_t base, uint32_t sequence, uint32_t trigger, uint32_t priority);
+void ADCSequenceStepConfigure (uint32_t base, uint32_t sequence, uint32_t step, uint32_t config);
+void ADCSequenceEnable (uint32_t base, uint32_t sequence);
+void ADCHardwareOversampleConfigure (uint32_t base, uint32_t factor);
+void ADCProcessorTrigger (uint32_t base, uint32_t sequence);
+uint32_t ADCIntStatus (uint32_t base, uint32_t sequence, bool masked);
+void ADCIntClear (uint32_t base, uint32_t sequence);
+int32_t ADCSequenceDataGet (uint32_t base, uint32_t sequence, uint32_t *buffer);
+void ADCIntRegister (uint32_t base, uint32_t sequence, void (*handler)(void));
+void ADCIntEnableEx (uint32_t base, uint32_t flags);
+void ADCIntClearEx (uint32_t base, uint32_t flags);
+void ADCSequenceDMAEnable (uint32_t base, uint32_t sequence);
+
+void ADCComparatorConfigure (uint32_t base, uint32_t comp, uint32_t config);
+void ADCComparatorRegionSet (uint32_t base, uint32_t comp, uint32_t low, uint32_t high);
+void ADCComparatorReset (uint32_t base, uint32_t comp, bool trigger, bool interrupt);
+void ADCComparatorIntEnable (uint32_t base, uint32_t sequence);
+uint32_t ADCComparatorIntStatus (uint32_t base);
+void ADCComparatorIntClear (uint32_t base, uint32_t status);
+
+/* *****************************************************************************
+ * Fake ADC model
+ * Each conversion returns the value of the input source, or the input level if
+ * no source is set. Hardware oversampling averages (truncating) that many
+ * conversions per step. A processor trigger completes the sequence at once,
+ * filling its FIFO with one value per configured step.
+ */
+#define FAKE_ADC_SEQUENCERS 4
+#define FAKE_ADC_STEPS 8
+#define FAKE_ADC_COMPARATORS 8
+
+typedef struct {
+	uint32_t trigger;
+	uint32_t steps[FAKE_ADC_STEPS];
+	uint32_t stepCount;			// steps up to and including the one with ADC_CTL_END
+	bool enabled;
+	bool intPending;
+	uint32_t fifo[FAKE_ADC_STEPS];
+	uint32_t fifoCount;
+	uint32_t triggers;
+	bool dma;					// results moved by the uDMA rather than the FIFO
+	bool comparatorInt;			// comparator interrupts enabled
+	void (*handler)(void);
+} fakeAdcSequencer_t;
+
+typedef struct {
+	uint32_t config;
+	uint32_t low;
+	uint32_t high;
+	bool armed;					// a ONCE interrupt may fire on entering the region
+} fakeAdcComparator_t;
+
+extern fakeAdcSequencer_t g_fakeAdcSequencers[FAKE_ADC_SEQUENCERS];
+extern fakeAdcComparator_t g_fakeAdcComparators[FAKE_ADC_COMPARATORS];
+extern uint32_t g_fakeAdcOversample;
+
+/* *****************************************************************************
+ * Fake digital comparator model
+ * Each step of an enabled ADC_TRIGGER_ALWAYS sequencer that is routed to a
+ * comparator (ADC_CTL_CMPn) compares the input level with it. Only the ONCE
+ * modes are modelled: the low band is below the low threshold and the high
+ * band at or above the high threshold. A ONCE comparator interrupts when the
+ * level enters its band, then not again until the level leaves it or
+ * ADCComparatorReset is called. The interrupt calls the handler registered for
+ * the sequencer, once comparator interrupts are enabled for it.
+ */
+
+/* *****************************************************************************
+ * fakeAdcSetLevel: sets a constant input level, used when no source is set,
+ * and runs the continuous sequencers (and so the comparators) until they
+ * raise no new interrupts.
+ */
+void fakeAdcSetLevel (uint32_t level);
+
+/* *****************************************************************************
+ * fakeAdcSetSource: sets a function that returns each conversion, or NULL to
+ * use the input level.
+ */
+void fakeAdcSetSource (uint32_t (*source)(void));
+
+/* *****************************************************************************
+ * fakeAdcDropNext: the next triggered batch loses its last count FIFO entries.
+ */
+void fakeAdcDropNext (uint32_t count);
+
+/* *****************************************************************************
+ * Timers
+ */
+#define TIMER0_BASE 0x40030000
+#define TIMER1_BASE 0x40031000
+#define TIMER2_BASE 0x40032000
+#define TIMER_A 0x000000FF
+#define TIMER_CFG_PERIODIC 0x00000022
+
+void TimerConfigure (uint32_t base, uint32_t config);
+void TimerLoadSet (uint32_t base, uint32_t timer, uint32_t value);
+void TimerControlTrigger (uint32_t base, uint32_t timer, bool enable);
+void TimerEnable (uint32_t base, uint32_t timer);
+uint32_t TimerValueGet (uint32_t base, uint32_t timer);
+
+/* *****************************************************************************
+ * Fake timer model, for timers 0 to 2 (timer A only)
+ * A periodic timer counts down from its load value to 0, then reloads.
+ */
+#define FAKE_TIMERS 3
+#define FAKE_TIMER(base) (&g_fakeTimers[((base) - TIMER0_BASE) >> 12])
+
+typedef struct {
+	uint32_t load;
+	uint32_t value;
+	bool enabled;
+	bool trigger;				// triggers the ADC at each timeout
+} fakeTimer_t;
+
+extern fakeTimer_t g_fakeTimers[FAKE_TIMERS];
+
+/* *****************************************************************************
+ * fakeTimerAdvance: lets ticks clock cycles pass on an enabled timer.
+ */
+void fakeTimerAdvance (uint32_t base, uint32_t ticks);
+
+/* *****************************************************************************
+ * uDMA
+ */
+#define UDMA_CHANNEL_ADC3 17
+#define UDMA_PRI_SELECT 0x00000000
+#define UDMA_ALT_SELECT 0x00000020
+
+#define UDMA_ATTR_USEBURST 0x00000001
+#define UDMA_ATTR_ALTSELECT 0x00000002
+#define UDMA_ATTR_HIGH_PRIORITY 0x00000004
+#define UDMA_ATTR_REQMASK 0x00000008
+
+#define UDMA_MODE_STOP 0x00000000
+#define UDMA_MODE_PINGPONG 0x00000003
+
+#define UDMA_SIZE_16 0x11000000
+#define UDMA_SRC_INC_NONE 0x0c000000
+#define UDMA_DST_INC_16 0x40000000
+#define UDMA_ARB_1 0x00000000
+
+void uDMAEnable (void);
+void uDMAControlBaseSet (void *controlTable);
+void uDMAChannelAttributeDisable (uint32_t channel, uint32_t attributes);
+void uDMAChannelControlSet (uint32_t channelSelect, uint32_t control);
+void uDMAChannelTransferSet (uint32_t channelSelect, uint32_t mode, void *source, void *dest,
+		uint32_t size);
+void uDMAChannelEnable (uint32_t channel);
+bool uDMAChannelIsEnabled (uint32_t channel);
+uint32_t uDMAChannelModeGet (uint32_t channelSelect);
+
+/* *****************************************************************************
+ * Fake uDMA model, for the ADC sequencer 3 channel only
+ * Each timer tick converts one sample, which the channel writes to the active
+ * (primary or alternate) transfer. A completed transfer stops, raises the
+ * ADC_INT_DMA_SS3 interrupt and hands over to the other transfer; if that one
+ * has stopped too, the channel is disabled and samples are lost until it is
+ * re-enabled.
+ */
+typedef struct {
+	uint32_t mode;
+	uint16_t *dest;
+	uint32_t size;
+	uint32_t done;
+} fakeDmaTransfer_t;
+
+extern fakeDmaTransfer_t g_fakeDmaTransfers[2]; // primary, alternate
+extern uint32_t g_fakeDmaLost;
+
+/* *****************************************************************************
+ * fakeTimerTick: one period of the ADC trigger timer (timer 1).
+ */
+void fakeTimerTick (void);
+
+/* *****************************************************************************
+ * QEI
+ */
+#define QEI_O_CTL 0x00000000
+#define QEI_CTL_RESMODE 0x00000010
+#define QEI_CTL_INVI 0x00000400
+
+#define QEI_CONFIG_CAPTURE_A_B 0x00000008
+#define QEI_CONFIG_RESET_IDX 0x00000010
+#define QEI_CONFIG_QUADRATURE 0x00000000
+#define QEI_CONFIG_NO_SWAP 0x00000000
+#define QEI_VELDIV_1 0x00000000
+
+#define QEI_INTERROR 0x00000008
+#define QEI_INTDIR 0x00000004
+#define QEI_INTTIMER 0x00000002
+#define QEI_INTINDEX 0x00000001
+
+void QEIEnable (uint32_t base);
+void QEIDisable (uint32_t base);
+void QEIConfigure (uint32_t base, uint32_t config, uint32_t maxPosition);
+uint32_t QEIPositionGet (uint32_t base);
+void QEIPositionSet (uint32_t base, uint32_t position);
+int32_t QEIDirectionGet (uint32_t base);
+void QEIVelocityConfigure (uint32_t base, uint32_t preDiv, uint32_t period);
+void QEIVelocityEnable (uint32_t base);
+uint32_t QEIVelocityGet (uint32_t base);
+void QEIIntRegister (uint32_t base, void (*handler)(void));
+void QEIIntEnable (uint32_t base, uint32_t flags);
+void QEIIntDisable (uint32_t base, uint32_t flags);
+uint32_t QEIIntStatus (uint32_t base, bool masked);
+void QEIIntClear (uint32_t base, uint32_t flags);
+
+/* *****************************************************************************
+ * Fake QEI model, for QEI1 only
+ * The position counts edges in [0, maxPosition], wrapping at either end, and
+ * is reset to 0 by an index pulse while QEI_CTL_RESMODE is set in the control
+ * register. The velocity capture counts edges (of either direction) over each
+ * period. Interrupts call the registered handler.
+ */
+typedef struct {
+	bool enabled;
+	uint32_t maxPosition;
+	uint32_t position;
+	int32_t direction;
+	uint32_t velocityPeriod;
+	uint32_t velocityEdges;		// edges in the current period
+	uint32_t velocity;			// edges in the last complete period
+	uint32_t intEnabled;
+	uint32_t intStatus;
+	void (*handler)(void);
+} fakeQei_t;
+
+extern fakeQei_t g_fakeQei;
+
+/* *****************************************************************************
+ * fakeQeiStep: moves the encoder by edges counts, clockwise if positive.
+ */
+void fakeQeiStep (int32_t edges);
+
+/* *****************************************************************************
+ * fakeQeiIndex: an index (reference) pulse.
+ */
+void fakeQeiIndex (void);
+
+/* *****************************************************************************
+ * fakeQeiVelocityPeriod: the end of a velocity capture period.
+ */
+void fakeQeiVelocityPeriod (void);
+
+/* *****************************************************************************
+ * fakeQeiPhaseError: both channels changed at once.
+ */
+void fakeQeiPhaseError (void);
+
+#endif /* FAKETIVA_H_ */
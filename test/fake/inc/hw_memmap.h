@@ -0,0 +1,2 @@
+/* Forwards to the fake TivaWare (see fakeTiva.h) */
+#include "fakeTiva.h"
@@ -0,0 +1,140 @@
+/* *****************************************************************************
+ * testAltimeterDma.c
+ *
+ * Host tests for the altimeter in ALT_ACQ_DMA mode, against the fake timer,
+ * ADC and uDMA: set-up, one stored sample per block in ping-pong order, and
+ * recovery when both blocks complete before the interrupt is serviced.
+ *
+ * Hangwen Hu and Marc Katzef
+ * Last modified:  16.10.2026
+ */
+
+#include "testUtil.h"
+#include "fakeTiva.h"
+#include "altimeter.h"
+
+#include <stdint.h>
+
+#define GROUND_LEVEL 2800
+
+/* *****************************************************************************
+ * fillBlocks: runs the trigger timer for count whole blocks, the samples of
+ * block k taking the level base + k * step.
+ */
+static void
+fillBlocks (uint32_t count, uint32_t base, uint32_t step)
+{
+	uint32_t block;
+	uint32_t i;
+
+	for (block = 0; block < count; block++) {
+		fakeAdcSetLevel(base + block * step);
+		for (i = 0; i < ALT_DMA_BLOCK_SIZE; i++) {
+			fakeTimerTick();
+		}
+	}
+}
+
+
+/* *****************************************************************************
+ * testSetup: sequencer 3 is triggered by the timer at ALT_DMA_SAMPLE_RATE, and
+ * the ping and pong transfers are armed.
+ */
+static void
+testSetup (void)
+{
+	fakeAdcSequencer_t *sequencer = &g_fakeAdcSequencers[ALT_SINGLE_SEQUENCER];
+
+	CHECK_EQUAL(FAKE_TIMER(ALT_DMA_TIMER_BASE)->load, FAKE_CLOCK_HZ / ALT_DMA_SAMPLE_RATE);
+	CHECK(FAKE_TIMER(ALT_DMA_TIMER_BASE)->trigger);
+	CHECK_EQUAL(sequencer->trigger, ADC_TRIGGER_TIMER);
+	CHECK(sequencer->dma);
+	CHECK(uDMAChannelIsEnabled(ALT_DMA_CHANNEL));
+	CHECK_EQUAL(uDMAChannelModeGet(ALT_DMA_CHANNEL | UDMA_PRI_SELECT), UDMA_MODE_PINGPONG);
+	CHECK_EQUAL(uDMAChannelModeGet(ALT_DMA_CHANNEL | UDMA_ALT_SELECT), UDMA_MODE_PINGPONG);
+	CHECK_EQUAL(g_fakeDmaTransfers[0].size, ALT_DMA_BLOCK_SIZE);
+	CHECK(g_fakeDmaTransfers[0].dest != g_fakeDmaTransfers[1].dest);
+}
+
+
+/* *****************************************************************************
+ * testBlocksInOrder: each block is reduced to one sample, stored in the order
+ * the blocks were filled, and calibration completes after a window of blocks.
+ * updateAltitude does nothing in this mode.
+ */
+static void
+testBlocksInOrder (void)
+{
+	circBufU16Reader_t reader;
+	uint16_t sample;
+	uint32_t i;
+
+	openAltitudeStream(&reader, CIRCBUF_SKIP_TO_OLDEST);
+	updateAltitude();
+	CHECK_EQUAL(readCircBufU16Reader(&reader, &sample), CIRCBUF_EMPTY);
+
+	fillBlocks(6, 1000, 10);
+	CHECK_EQUAL(getAltitudeBlockCount(), 6);
+	for (i = 0; i < 6; i++) {
+		CHECK_EQUAL(readCircBufU16Reader(&reader, &sample), CIRCBUF_OK);
+		CHECK_EQUAL(sample, 1000 + i * 10);
+	}
+	CHECK_EQUAL(readCircBufU16Reader(&reader, &sample), CIRCBUF_EMPTY);
+
+	fillBlocks(BUF_SIZE, GROUND_LEVEL, 0);
+	startAltimeterCalibration();
+	fillBlocks(1, GROUND_LEVEL, 0);
+	CHECK(altimeterCalibrated_p());
+	CHECK_EQUAL(getAltimeterGroundADCValue(), GROUND_LEVEL);
+	CHECK_EQUAL(g_fakeDmaLost, 0);
+}
+
+
+/* *****************************************************************************
+ * testBothBlocksPending: with the interrupt held off for two blocks, the uDMA
+ * finds neither block armed and stops. The handler must store both blocks,
+ * ping first, and restart the channel.
+ */
+static void
+testBothBlocksPending (void)
+{
+	circBufU16Reader_t reader;
+	uint32_t blocks;
+	uint16_t sample;
+
+	fillBlocks(getAltitudeBlockCount() & 1, GROUND_LEVEL, 0); // next block is ping
+	blocks = getAltitudeBlockCount();
+	openAltitudeStream(&reader, CIRCBUF_SKIP_TO_OLDEST);
+
+	IntMasterDisable();
+	fillBlocks(2, 2000, 100);
+	CHECK(!uDMAChannelIsEnabled(ALT_DMA_CHANNEL));
+	CHECK_EQUAL(getAltitudeBlockCount(), blocks);
+	IntMasterEnable();
+
+	CHECK_EQUAL(getAltitudeBlockCount(), blocks + 2);
+	CHECK_EQUAL(readCircBufU16Reader(&reader, &sample), CIRCBUF_OK);
+	CHECK_EQUAL(sample, 2000);
+	CHECK_EQUAL(readCircBufU16Reader(&reader, &sample), CIRCBUF_OK);
+	CHECK_EQUAL(sample, 2100);
+	CHECK(uDMAChannelIsEnabled(ALT_DMA_CHANNEL));
+
+	// Acquisition carries on from ping, losing nothing
+	fillBlocks(3, 3000, 1);
+	CHECK_EQUAL(getAltitudeBlockCount(), blocks + 5);
+	CHECK_EQUAL(circBufU16Peek(&reader.buffer[0], 0), 3002);
+	CHECK_EQUAL(g_fakeDmaLost, 0);
+}
+
+
+int
+main (void)
+{
+	fakeAdcSetLevel(GROUND_LEVEL);
+	initAltimeter();
+
+	testSetup();
+	testBlocksInOrder();
+	testBothBlocksPending();
+	return testReport("testAltimeterDma");
+}
@@ -0,0 +1,75 @@
+/* *****************************************************************************
+ * testAltimeterIir.c
+ *
+ * Host tests for the altimeter with ALT_FILTER_IIR, against the fake ADC: the
+ * primed CIC and IIR stages give no spurious altitude at start-up, and a
+ * climb settles on the altitude of the new level.
+ *
+ * Hangwen Hu and Marc Katzef
+ * Last modified:  16.10.2026
+ */
+
+#include "testUtil.h"
+#include "fakeTiva.h"
+#include "altimeter.h"
+
+#include <stdint.h>
+
+#define GROUND_LEVEL 3000
+#define CLIMB_LEVEL 2500
+
+/* *****************************************************************************
+ * testNoStartupDip: from the first sample, a steady ground level reads as
+ * exactly zero altitude. An unprimed pipeline would rise from zero ADC
+ * counts, which reads as a high altitude.
+ */
+static void
+testNoStartupDip (void)
+{
+	uint32_t nonzero = 0;
+	uint32_t i;
+
+	restoreAltimeterCalibration(GROUND_LEVEL);
+	for (i = 0; i < 4 * BUF_SIZE; i++) {
+		updateAltitude();
+		if (getCurrentAltitudeTenths() != 0) {
+			nonzero++;
+		}
+	}
+	CHECK(altimeterCalibrated_p());
+	CHECK_EQUAL(getAltimeterGroundADCValue(), GROUND_LEVEL);
+	CHECK_EQUAL(nonzero, 0);
+}
+
+
+/* *****************************************************************************
+ * testClimb: a step in the ADC level settles on the matching altitude.
+ */
+static void
+testClimb (void)
+{
+	uint32_t maxADCValue = GROUND_LEVEL - (ALTITUDE_RANGE_VOLTS * (1 << ADC_WIDTH_BITS)) / ADC_RANGE_VOLTS;
+	uint32_t range = GROUND_LEVEL - maxADCValue;
+	int32_t expected = ((GROUND_LEVEL - CLIMB_LEVEL) * 1000 + range / 2) / range;
+	int32_t tenths;
+	uint32_t i;
+
+	fakeAdcSetLevel(CLIMB_LEVEL);
+	for (i = 0; i < 100; i++) {
+		updateAltitude();
+	}
+	tenths = getCurrentAltitudeTenths();
+	CHECK(tenths >= expected - 1 && tenths <= expected + 1);
+}
+
+
+int
+main (void)
+{
+	fakeAdcSetLevel(GROUND_LEVEL);
+	initAltimeter();
+
+	testNoStartupDip();
+	testClimb();
+	return testReport("testAltimeterIir");
+}
@@ -0,0 +1,166 @@
+/* *****************************************************************************
+ * testAltimeterOversampled.c
+ *
+ * Host tests for the altimeter in ALT_ACQ_OVERSAMPLED mode, against the fake
+ * ADC: sequencer set-up, noise reduction by hardware averaging, calibration,
+ * and handling of incomplete or missing batches.
+ *
+ * Hangwen Hu and Marc Katzef
+ * Last modified:  16.10.2026
+ */
+
+#include "testUtil.h"
+#include "fakeTiva.h"
+#include "altimeter.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#define GROUND_LEVEL 3000
+#define NOISE_SPAN 128 // raw conversions are uniform over this many counts
+
+/* *****************************************************************************
+ * noisySource: a conversion of the ground level with uniform noise, whose
+ * variance is about NOISE_SPAN^2 / 12.
+ */
+static uint32_t
+noisySource (void)
+{
+	return GROUND_LEVEL - NOISE_SPAN / 2 + (rand() % NOISE_SPAN);
+}
+
+
+/* *****************************************************************************
+ * pollAltitude: calls updateAltitude count times, as the SysTick ISR would.
+ */
+static void
+pollAltitude (uint32_t count)
+{
+	while (count--) {
+		updateAltitude();
+	}
+}
+
+
+/* *****************************************************************************
+ * testSequencerSetup: sequencer 0 converts the altitude channel in every step,
+ * interrupting after the last, with hardware averaging enabled.
+ */
+static void
+testSequencerSetup (void)
+{
+	fakeAdcSequencer_t *sequencer = &g_fakeAdcSequencers[ALT_BATCH_SEQUENCER];
+	uint32_t step;
+
+	CHECK_EQUAL(g_fakeAdcOversample, ALT_HW_OVERSAMPLE);
+	CHECK(sequencer->enabled);
+	CHECK_EQUAL(sequencer->trigger, ADC_TRIGGER_PROCESSOR);
+	CHECK_EQUAL(sequencer->stepCount, ALT_BATCH_STEPS);
+	for (step = 0; step < ALT_BATCH_STEPS; step++) {
+		CHECK_EQUAL(sequencer->steps[step] & 0xF, ALTITUDE_ADC_CHANNEL);
+	}
+	CHECK(sequencer->steps[ALT_BATCH_STEPS - 1] & ADC_CTL_IE);
+	CHECK_EQUAL(sequencer->triggers, 1);
+}
+
+
+/* *****************************************************************************
+ * testCalibration: a full window of a steady level calibrates the ground to
+ * that level.
+ */
+static void
+testCalibration (void)
+{
+	CHECK(!altimeterCalibrated_p());
+	pollAltitude(BUF_SIZE - 1);
+	CHECK(!altimeterCalibrated_p());
+	CHECK_EQUAL(getAltimeterCalibrationProgress(), (BUF_SIZE - 1) * 100 / BUF_SIZE);
+	pollAltitude(1);
+	CHECK(altimeterCalibrated_p());
+	CHECK_EQUAL(getAltimeterGroundADCValue(), GROUND_LEVEL);
+	CHECK_EQUAL(getCurrentAltitude(), 0);
+}
+
+
+/* *****************************************************************************
+ * testNoiseReduction: each stored sample averages ALT_BATCH_STEPS *
+ * ALT_HW_OVERSAMPLE conversions, so the window variance is far below the raw
+ * conversion variance.
+ */
+static void
+testNoiseReduction (void)
+{
+	uint32_t rawVariance = NOISE_SPAN * NOISE_SPAN / 12;
+
+	srand(9);
+	fakeAdcSetSource(noisySource);
+	pollAltitude(4 * BUF_SIZE);
+	fakeAdcSetSource(NULL);
+
+	CHECK(getAltitudeNoise() * 32 < rawVariance);
+	CHECK(getAltitudeADCMin() >= GROUND_LEVEL - NOISE_SPAN / 8);
+	CHECK(getAltitudeADCMax() <= GROUND_LEVEL + NOISE_SPAN / 8);
+	pollAltitude(BUF_SIZE);
+	CHECK_EQUAL(getAltitudeNoise(), 0);
+}
+
+
+/* *****************************************************************************
+ * testIncompleteBatch: a batch missing FIFO entries is skipped, and the next
+ * batch is still triggered.
+ */
+static void
+testIncompleteBatch (void)
+{
+	fakeAdcSequencer_t *sequencer = &g_fakeAdcSequencers[ALT_BATCH_SEQUENCER];
+	circBufU16Reader_t reader;
+	uint32_t triggers;
+	uint16_t sample;
+	uint32_t stored = 0;
+
+	openAltitudeStream(&reader, CIRCBUF_SKIP_TO_OLDEST);
+	fakeAdcDropNext(1);
+	triggers = sequencer->triggers;
+
+	pollAltitude(3); // full batch, short batch, full batch
+	while (readCircBufU16Reader(&reader, &sample) == CIRCBUF_OK) {
+		CHECK_EQUAL(sample, GROUND_LEVEL);
+		stored++;
+	}
+	CHECK_EQUAL(stored, 2);
+	CHECK_EQUAL(sequencer->triggers, triggers + 3);
+}
+
+
+/* *****************************************************************************
+ * testNoBatchReady: nothing is stored or triggered until the batch completes.
+ */
+static void
+testNoBatchReady (void)
+{
+	fakeAdcSequencer_t *sequencer = &g_fakeAdcSequencers[ALT_BATCH_SEQUENCER];
+	circBufU16Reader_t reader;
+	uint32_t triggers = sequencer->triggers;
+	uint16_t sample;
+
+	openAltitudeStream(&reader, CIRCBUF_SKIP_TO_OLDEST);
+	ADCIntClear(ALTITUDE_ADC_BASE, ALT_BATCH_SEQUENCER);
+	pollAltitude(1);
+	CHECK_EQUAL(readCircBufU16Reader(&reader, &sample), CIRCBUF_EMPTY);
+	CHECK_EQUAL(sequencer->triggers, triggers);
+}
+
+
+int
+main (void)
+{
+	fakeAdcSetLevel(GROUND_LEVEL);
+	initAltimeter();
+
+	testSequencerSetup();
+	testCalibration();
+	testNoiseReduction();
+	testIncompleteBatch();
+	testNoBatchReady();
+	return testReport("testAltimeterOversampled");
+}
@@ -0,0 +1,126 @@
+/* *****************************************************************************
+ * testAltitudeConversion.c
+ *
+ * Host tests for the fixed-point altitude conversion, against the fake ADC:
+ * every ADC value is converted with several ground calibrations and compared
+ * with the exact altitude and, within the 0-100% range, with the previous
+ * division-based formula (which rounds altitudes above 100% towards zero).
+ *
+ * Hangwen Hu and Marc Katzef
+ * Last modified:  16.10.2026
+ */
+
+#include "testUtil.h"
+#include "fakeTiva.h"
+#include "altimeter.h"
+
+#include <math.h>
+#include <stdint.h>
+
+#define ADC_MAX ((1 << ADC_WIDTH_BITS) - 1)
+// The Q16 scales are rounded by up to half a unit, so a conversion may be off
+// by up to 0.5 * ADC_MAX / 2^16 before rounding, tipping values that close to
+// a rounding tie either way
+#define TIE_MARGIN (0.5 * ADC_MAX / (1 << ALT_SCALE_SHIFT))
+
+/* *****************************************************************************
+ * setLevel: feeds a steady ADC value for a full window. Each poll reads the
+ * conversion triggered by the previous one, hence the extra poll.
+ */
+static void
+setLevel (uint32_t level)
+{
+	uint32_t i;
+
+	fakeAdcSetLevel(level);
+	for (i = 0; i <= BUF_SIZE; i++) {
+		updateAltitude();
+	}
+}
+
+
+/* *****************************************************************************
+ * previousAltitude: the altitude percentage as getCurrentAltitude computed it
+ * before the fixed-point conversion, with two divisions per call.
+ */
+static uint16_t
+previousAltitude (uint32_t ADCValue, uint32_t minADCValue, uint32_t maxADCValue)
+{
+	int32_t altPercNum = (ADCValue - maxADCValue) * 100;
+	int32_t altPercDenom = maxADCValue - minADCValue;
+
+	return MAX(0, (2 * altPercNum - altPercDenom) / (2 * altPercDenom) + 100);
+}
+
+
+/* *****************************************************************************
+ * matchesRounded: returns true if value is exact rounded to the nearest
+ * integer, or either neighbour when exact lies within TIE_MARGIN of a tie.
+ */
+static bool
+matchesRounded (int32_t value, double exact)
+{
+	double fraction = exact - floor(exact);
+
+	if (fabs(fraction - 0.5) < TIE_MARGIN) {
+		return (value == (int32_t)floor(exact)) || (value == (int32_t)ceil(exact));
+	}
+	return value == (int32_t)floor(exact + 0.5);
+}
+
+
+/* *****************************************************************************
+ * testFullRange: converts every ADC value with the given ground calibration.
+ */
+static void
+testFullRange (uint32_t ground)
+{
+	uint32_t percentFailures = 0;
+	uint32_t tenthsFailures = 0;
+	uint32_t previousFailures = 0;
+	uint32_t maxADCValue;
+	uint32_t range;
+	uint32_t ADCValue;
+
+	setLevel(ground);
+	startAltimeterCalibration();
+	setLevel(ground);
+	CHECK(altimeterCalibrated_p());
+	CHECK_EQUAL(getAltimeterGroundADCValue(), ground);
+
+	maxADCValue = ground - (ALTITUDE_RANGE_VOLTS * (1 << ADC_WIDTH_BITS)) / ADC_RANGE_VOLTS;
+	range = ground - maxADCValue;
+
+	for (ADCValue = 0; ADCValue <= ADC_MAX; ADCValue++) {
+		double exact = (ADCValue >= ground) ? 0.0 : (ground - ADCValue) * 100.0 / range;
+		uint16_t percent;
+
+		setLevel(ADCValue);
+		percent = getCurrentAltitude();
+		if (!matchesRounded(percent, exact)) {
+			percentFailures++;
+		}
+		if (!matchesRounded(getCurrentAltitudeTenths(), exact * 10)) {
+			tenthsFailures++;
+		}
+		if ((ADCValue <= ground) && (ADCValue >= maxADCValue) && (percent != previousAltitude(ADCValue, ground, maxADCValue))
+				&& !matchesRounded(previousAltitude(ADCValue, ground, maxADCValue), exact)) {
+			previousFailures++;
+		}
+	}
+	CHECK_EQUAL(percentFailures, 0);
+	CHECK_EQUAL(tenthsFailures, 0);
+	CHECK_EQUAL(previousFailures, 0);
+}
+
+
+int
+main (void)
+{
+	initAltimeter();
+
+	testFullRange(1500);
+	testFullRange(2500);
+	testFullRange(ADC_MAX);
+	return testReport("testAltitudeConversion");
+}
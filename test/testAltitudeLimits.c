@@ -0,0 +1,178 @@
+/* *****************************************************************************
+ * testAltitudeLimits.c
+ *
+ * Host tests for the altitude limits, against the fake ADC digital
+ * comparators: entry events fire once per crossing, exits need the
+ * hysteresis, interrupts held off are delivered late, and thresholds follow
+ * recalibration.
+ *
+ * Hangwen Hu and Marc Katzef
+ * Last modified:  16.10.2026
+ */
+
+#include "testUtil.h"
+#include "fakeTiva.h"
+#include "altimeter.h"
+
+#include <stdint.h>
+
+#define GROUND_LEVEL 3000
+#define GROUND_PERCENT 5
+#define CEILING_PERCENT 90
+
+/* *****************************************************************************
+ * levelAt: returns the ADC level of an altitude percentage above ground, as
+ * the altimeter computes its thresholds.
+ */
+static uint32_t
+levelAt (uint32_t ground, uint32_t percent)
+{
+	uint32_t maxADCValue = ground - (ALTITUDE_RANGE_VOLTS * (1 << ADC_WIDTH_BITS)) / ADC_RANGE_VOLTS;
+	uint32_t range = ground - maxADCValue;
+
+	return ground - (percent * range + 50) / 100;
+}
+
+
+/* *****************************************************************************
+ * calibrate: fills the window with a steady ground level, then calibrates to
+ * it. Each poll reads the conversion triggered by the previous one, hence the
+ * extra poll.
+ */
+static void
+calibrate (uint32_t ground)
+{
+	uint32_t i;
+
+	fakeAdcSetLevel(ground);
+	for (i = 0; i <= BUF_SIZE; i++) {
+		updateAltitude();
+	}
+	startAltimeterCalibration();
+	updateAltitude();
+}
+
+
+/* *****************************************************************************
+ * testUncalibrated: no comparator interrupts before the first calibration.
+ */
+static void
+testUncalibrated (void)
+{
+	setAltitudeLimits(GROUND_PERCENT, CEILING_PERCENT);
+	CHECK_EQUAL(g_fakeAdcComparators[ALT_LIMIT_GROUND].config, ADC_COMP_INT_NONE);
+	CHECK_EQUAL(g_fakeAdcComparators[ALT_LIMIT_CEILING].config, ADC_COMP_INT_NONE);
+
+	fakeAdcSetLevel(100);
+	fakeAdcSetLevel(4000);
+	CHECK(!altitudeLimitActive_p(ALT_LIMIT_GROUND));
+	CHECK(!altitudeLimitActive_p(ALT_LIMIT_CEILING));
+	CHECK(!checkAltitudeEvent(ALT_LIMIT_CEILING));
+}
+
+
+/* *****************************************************************************
+ * testGroundAndCeiling: entering each limit raises one event, however long
+ * the level stays beyond it; leaving raises none.
+ */
+static void
+testGroundAndCeiling (void)
+{
+	calibrate(GROUND_LEVEL);
+	CHECK(altimeterCalibrated_p());
+
+	fakeAdcSetLevel(GROUND_LEVEL);
+	CHECK(altitudeLimitActive_p(ALT_LIMIT_GROUND));
+	CHECK(checkAltitudeEvent(ALT_LIMIT_GROUND));
+	CHECK(!checkAltitudeEvent(ALT_LIMIT_GROUND));
+
+	fakeAdcSetLevel(levelAt(GROUND_LEVEL, 50));
+	CHECK(!altitudeLimitActive_p(ALT_LIMIT_GROUND));
+	CHECK(!altitudeLimitActive_p(ALT_LIMIT_CEILING));
+	CHECK(!checkAltitudeEvent(ALT_LIMIT_GROUND));
+
+	fakeAdcSetLevel(levelAt(GROUND_LEVEL, 95));
+	fakeAdcSetLevel(levelAt(GROUND_LEVEL, 96));
+	fakeAdcSetLevel(levelAt(GROUND_LEVEL, 95));
+	CHECK(altitudeLimitActive_p(ALT_LIMIT_CEILING));
+	CHECK(checkAltitudeEvent(ALT_LIMIT_CEILING));
+	CHECK(!checkAltitudeEvent(ALT_LIMIT_CEILING));
+}
+
+
+/* *****************************************************************************
+ * testHysteresis: the ceiling only clears once the level is ALT_LIMIT_HYSTERESIS
+ * counts below the threshold, and is then entered again at the threshold.
+ */
+static void
+testHysteresis (void)
+{
+	uint32_t threshold = levelAt(GROUND_LEVEL, CEILING_PERCENT);
+
+	fakeAdcSetLevel(threshold + ALT_LIMIT_HYSTERESIS / 2);
+	CHECK(altitudeLimitActive_p(ALT_LIMIT_CEILING));
+	fakeAdcSetLevel(threshold + ALT_LIMIT_HYSTERESIS);
+	CHECK(!altitudeLimitActive_p(ALT_LIMIT_CEILING));
+	fakeAdcSetLevel(threshold);
+	CHECK(!altitudeLimitActive_p(ALT_LIMIT_CEILING));
+	fakeAdcSetLevel(threshold - 1);
+	CHECK(altitudeLimitActive_p(ALT_LIMIT_CEILING));
+	CHECK(checkAltitudeEvent(ALT_LIMIT_CEILING));
+}
+
+
+/* *****************************************************************************
+ * testHeldInterrupt: a crossing while interrupts are disabled is handled when
+ * they are enabled again, and clearAltitudeEvents discards its event.
+ */
+static void
+testHeldInterrupt (void)
+{
+	fakeAdcSetLevel(levelAt(GROUND_LEVEL, 50));
+	CHECK(!altitudeLimitActive_p(ALT_LIMIT_CEILING));
+
+	IntMasterDisable();
+	fakeAdcSetLevel(levelAt(GROUND_LEVEL, 95));
+	CHECK(!altitudeLimitActive_p(ALT_LIMIT_CEILING));
+	IntMasterEnable();
+	CHECK(altitudeLimitActive_p(ALT_LIMIT_CEILING));
+
+	clearAltitudeEvents();
+	CHECK(!checkAltitudeEvent(ALT_LIMIT_CEILING));
+}
+
+
+/* *****************************************************************************
+ * testRecalibration: the thresholds move with a new ground level.
+ */
+static void
+testRecalibration (void)
+{
+	uint32_t ground = GROUND_LEVEL + 200;
+
+	calibrate(ground);
+	clearAltitudeEvents();
+	CHECK(!altitudeLimitActive_p(ALT_LIMIT_CEILING));
+	CHECK_EQUAL(g_fakeAdcComparators[ALT_LIMIT_CEILING].low, levelAt(ground, CEILING_PERCENT));
+
+	fakeAdcSetLevel(levelAt(ground, 50));
+	fakeAdcSetLevel(levelAt(ground, 3));
+	CHECK(altitudeLimitActive_p(ALT_LIMIT_GROUND));
+	CHECK(checkAltitudeEvent(ALT_LIMIT_GROUND));
+	CHECK(!altitudeLimitActive_p(ALT_LIMIT_CEILING));
+}
+
+
+int
+main (void)
+{
+	fakeAdcSetLevel(GROUND_LEVEL);
+	initAltimeter();
+
+	testUncalibrated();
+	testGroundAndCeiling();
+	testHysteresis();
+	testHeldInterrupt();
+	testRecalibration();
+	return testReport("testAltitudeLimits");
+}
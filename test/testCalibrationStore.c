@@ -0,0 +1,217 @@
+/* *****************************************************************************
+ * testCalibrationStore.c
+ *
+ * Host tests for calibrationStore, against the file-backed fake nvStorage:
+ * round trips across a simulated restart, rejection of blank, foreign, stale
+ * and corrupted records, and the tolerance check of
+ * restoreAltimeterCalibration against the fake ADC.
+ *
+ * Hangwen Hu and Marc Katzef
+ * Last modified:  16.10.2026
+ */
+
+#include "testUtil.h"
+#include "fakeTiva.h"
+#include "fakeNvStorage.h"
+#include "nvStorage.h"
+#include "calibrationStore.h"
+#include "altimeter.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define NV_FILE "build/testCalibrationStore.nv"
+#define GROUND 2000 // ADC value of the level fed to the altimeter
+
+/* *****************************************************************************
+ * referenceCrc: the standard byte-wise CRC-32 (IEEE 802.3, as in zlib) of
+ * length bytes, for checking and forging records.
+ */
+static uint32_t
+referenceCrc (const void *data, size_t length)
+{
+	const uint8_t *bytes = data;
+	uint32_t crc = 0xFFFFFFFF;
+	size_t i;
+	int bit;
+
+	for (i = 0; i < length; i++) {
+		crc ^= bytes[i];
+		for (bit = 0; bit < 8; bit++) {
+			crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : crc >> 1;
+		}
+	}
+	return ~crc;
+}
+
+
+/* *****************************************************************************
+ * writeRawRecord: stores record as it is, without loadCalibration's fields
+ * being set, as a corrupted or older firmware might have left it.
+ */
+static void
+writeRawRecord (const calibrationRecord_t *record)
+{
+	CHECK(writeNvStorage(NV_CALIBRATION_ADDRESS, (const uint32_t *)record, sizeof(*record)));
+}
+
+
+/* *****************************************************************************
+ * restart: simulates a power cycle of the storage.
+ */
+static void
+restart (void)
+{
+	fakeNvStorageUse(NV_FILE);
+	CHECK(initNvStorage());
+}
+
+
+/* *****************************************************************************
+ * testRoundTrip: a saved record loads back unchanged after a restart, with the
+ * magic number, version and standard CRC-32 filled in. A blank (erased)
+ * storage holds no record.
+ */
+static void
+testRoundTrip (void)
+{
+	calibrationRecord_t saved = {.altGroundADCValue = 2345, .flags = CALIBRATION_YAW_AT_REF};
+	calibrationRecord_t loaded;
+
+	remove(NV_FILE);
+	restart();
+	CHECK(!loadCalibration(&loaded));
+
+	CHECK(saveCalibration(&saved));
+	CHECK_EQUAL(saved.magic, CALIBRATION_MAGIC);
+	CHECK_EQUAL(saved.version, CALIBRATION_VERSION);
+	CHECK_EQUAL(saved.crc, referenceCrc(&saved, offsetof(calibrationRecord_t, crc)));
+
+	restart();
+	CHECK(loadCalibration(&loaded));
+	CHECK_EQUAL(loaded.altGroundADCValue, 2345);
+	CHECK_EQUAL(loaded.flags, CALIBRATION_YAW_AT_REF);
+	CHECK_EQUAL(loaded.crc, saved.crc);
+
+	fakeNvStorageErase();
+	restart();
+	CHECK(!loadCalibration(&loaded));
+}
+
+
+/* *****************************************************************************
+ * testRejection: records with a wrong magic number or an older version are
+ * rejected even with a valid CRC, and a record with a bit flipped after it was
+ * saved is rejected by its CRC.
+ */
+static void
+testRejection (void)
+{
+	calibrationRecord_t record = {.altGroundADCValue = 1800};
+	calibrationRecord_t loaded;
+
+	CHECK(saveCalibration(&record));
+	record.magic = CALIBRATION_MAGIC ^ 0x20;
+	record.crc = referenceCrc(&record, offsetof(calibrationRecord_t, crc));
+	writeRawRecord(&record);
+	CHECK(!loadCalibration(&loaded));
+
+	record.magic = CALIBRATION_MAGIC;
+	record.version = CALIBRATION_VERSION - 1;
+	record.crc = referenceCrc(&record, offsetof(calibrationRecord_t, crc));
+	writeRawRecord(&record);
+	CHECK(!loadCalibration(&loaded));
+
+	CHECK(saveCalibration(&record));
+	CHECK(loadCalibration(&loaded));
+	record.altGroundADCValue ^= 0x100;
+	writeRawRecord(&record);
+	restart();
+	CHECK(!loadCalibration(&loaded));
+}
+
+
+/* *****************************************************************************
+ * pollAltitude: polls the altimeter count times at the current fake ADC level.
+ * Each poll stores the conversion triggered by the previous poll (or by
+ * initAltimeter), so stores one sample.
+ */
+static void
+pollAltitude (uint32_t count)
+{
+	uint32_t i;
+
+	for (i = 0; i < count; i++) {
+		updateAltitude();
+	}
+}
+
+
+/* *****************************************************************************
+ * checkRestore: restarts the altimeter with restored offered, at a steady
+ * level of GROUND. If accepted, calibration must complete with restored after
+ * ALT_RESTORE_SAMPLES samples; otherwise it must wait for a full buffer and
+ * complete with the measured GROUND.
+ */
+static void
+checkRestore (uint16_t restored, bool accepted)
+{
+	initAltimeter();
+	restoreAltimeterCalibration(restored);
+
+	pollAltitude(ALT_RESTORE_SAMPLES - 1); // One sample short
+	CHECK(!altimeterCalibrated_p());
+	pollAltitude(1);
+	CHECK_EQUAL(altimeterCalibrated_p(), accepted);
+	if (accepted) {
+		CHECK_EQUAL(getAltimeterGroundADCValue(), restored);
+		return;
+	}
+
+	pollAltitude(BUF_SIZE - ALT_RESTORE_SAMPLES - 1); // One sample short of full
+	CHECK(!altimeterCalibrated_p());
+	pollAltitude(1);
+	CHECK(altimeterCalibrated_p());
+	CHECK_EQUAL(getAltimeterGroundADCValue(), GROUND);
+}
+
+
+/* *****************************************************************************
+ * testRestoreTolerance: a saved ground within ALT_RESTORE_TOLERANCE of the
+ * level is used after a restart, either side; one just outside it is
+ * discarded in favour of a full recalibration.
+ */
+static void
+testRestoreTolerance (void)
+{
+	calibrationRecord_t record;
+
+	fakeAdcSetLevel(GROUND);
+	initAltimeter();
+	pollAltitude(BUF_SIZE);
+	CHECK(altimeterCalibrated_p());
+	record.altGroundADCValue = getAltimeterGroundADCValue();
+	record.flags = 0;
+	CHECK(saveCalibration(&record));
+
+	restart();
+	CHECK(loadCalibration(&record));
+	checkRestore(record.altGroundADCValue, true);
+
+	checkRestore(GROUND + ALT_RESTORE_TOLERANCE, true);
+	checkRestore(GROUND - ALT_RESTORE_TOLERANCE, true);
+	checkRestore(GROUND + ALT_RESTORE_TOLERANCE + 1, false);
+	checkRestore(GROUND - ALT_RESTORE_TOLERANCE - 1, false);
+}
+
+
+int
+main (void)
+{
+	testRoundTrip();
+	testRejection();
+	testRestoreTolerance();
+	remove(NV_FILE);
+	return testReport("testCalibrationStore");
+}
@@ -0,0 +1,190 @@
+/* *****************************************************************************
+ * testCircBufStatic.c
+ *
+ * Host tests for the statically allocated circular buffers: bitmask wrapping,
+ * replaced entries and the running-sum mean against a rescan of the data, for
+ * integer, float and record entry types; and readers with their own cursors,
+ * including overruns and a buffer initialised under an attached reader.
+ *
+ * Hangwen Hu and Marc Katzef
+ * Last modified:  16.10.2026
+ */
+
+#include "testUtil.h"
+#include "circBufStatic.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+CIRCBUF_STATIC_DEFINE(U16, g_samples, 5);
+CIRCBUF_STATIC_DEFINE(U32, g_words, 2);
+CIRCBUF_STATIC_DEFINE(F32, g_states, 4);
+CIRCBUF_STATIC_DEFINE(Timed, g_log, 3);
+CIRCBUF_STATIC_DEFINE(U16, g_stream, 3);
+
+
+/* *****************************************************************************
+ * testWrap: reads follow writes through several laps, and each write returns
+ * the entry written one lap earlier.
+ */
+static void
+testWrap (void)
+{
+	uint32_t i;
+
+	CHECK_EQUAL(g_words.mask, 3);
+	for (i = 1; i <= 20; i++) {
+		CHECK_EQUAL(writeCircBufU32(&g_words, i), i > 4 ? i - 4 : 0);
+		CHECK_EQUAL(readCircBufU32(&g_words), i);
+		CHECK_EQUAL(circBufU32Peek(&g_words, 0), i);
+	}
+	CHECK_EQUAL(g_words.windex, 20 & g_words.mask);
+}
+
+
+/* *****************************************************************************
+ * testMean: the running-sum mean matches a rescan of the data array after
+ * every write of a random 12-bit sample.
+ */
+static void
+testMean (void)
+{
+	uint32_t size = g_samples.mask + 1;
+	uint32_t sum;
+	uint32_t i;
+	uint32_t j;
+
+	srand(2);
+	for (i = 0; i < 10 * size; i++) {
+		writeCircBufU16(&g_samples, rand() & 0xFFF);
+		sum = 0;
+		for (j = 0; j < size; j++) {
+			sum += g_samplesData[j];
+		}
+		CHECK_EQUAL(g_samples.sum, sum);
+		CHECK_EQUAL(circBufU16Mean(&g_samples), (2 * sum + size) / (2 * size));
+	}
+
+	initCircBufU16(&g_samples);
+	CHECK_EQUAL(g_samples.sum, 0);
+	CHECK_EQUAL(circBufU16Mean(&g_samples), 0);
+}
+
+
+/* *****************************************************************************
+ * testTypes: entries keep their own type, so a U16 buffer takes half the
+ * memory of a U32 one, floats keep their fraction and records round trip.
+ */
+static void
+testTypes (void)
+{
+	timedSample_t sample = {.timestamp = 123456, .value = 4095};
+	timedSample_t copy;
+	float sum = 0.0f;
+	uint32_t i;
+
+	CHECK_EQUAL(sizeof(g_samplesData), (g_samples.mask + 1) * sizeof(uint16_t));
+	CHECK_EQUAL(sizeof(g_samplesData[0]), 2);
+
+	for (i = 0; i < 40; i++) {
+		writeCircBufF32(&g_states, i + 0.25f);
+	}
+	for (i = 0; i <= g_states.mask; i++) {
+		sum += g_statesData[i];
+	}
+	CHECK(circBufF32Mean(&g_states) == sum / (g_states.mask + 1));
+	CHECK(circBufF32Peek(&g_states, 0) == 39.25f);
+
+	writeCircBufTimed(&g_log, sample);
+	copy = readCircBufTimed(&g_log);
+	CHECK_EQUAL(copy.timestamp, 123456);
+	CHECK_EQUAL(copy.value, 4095);
+}
+
+
+/* *****************************************************************************
+ * testReaders: two readers see the same entries independently; an overrun is
+ * counted and resolved by each reader's policy.
+ */
+static void
+testReaders (void)
+{
+	circBufU16Reader_t oldest;
+	circBufU16Reader_t newest;
+	uint16_t entry;
+	uint32_t i;
+
+	initCircBufU16(&g_stream);
+	initCircBufU16Reader(&oldest, &g_stream, CIRCBUF_SKIP_TO_OLDEST);
+	initCircBufU16Reader(&newest, &g_stream, CIRCBUF_SKIP_TO_NEWEST);
+	CHECK_EQUAL(readCircBufU16Reader(&oldest, &entry), CIRCBUF_EMPTY);
+
+	for (i = 1; i <= 3; i++) {
+		writeCircBufU16(&g_stream, i);
+	}
+	for (i = 1; i <= 3; i++) {
+		CHECK_EQUAL(readCircBufU16Reader(&oldest, &entry), CIRCBUF_OK);
+		CHECK_EQUAL(entry, i);
+		CHECK_EQUAL(readCircBufU16Reader(&newest, &entry), CIRCBUF_OK);
+		CHECK_EQUAL(entry, i);
+	}
+
+	// Lap both readers: 20 writes into 8 entries drop 12
+	for (i = 4; i <= 23; i++) {
+		writeCircBufU16(&g_stream, i);
+	}
+	CHECK_EQUAL(circBufU16ReaderLag(&oldest), 20);
+	CHECK_EQUAL(readCircBufU16Reader(&oldest, &entry), CIRCBUF_OK);
+	CHECK_EQUAL(entry, 16);
+	CHECK_EQUAL(oldest.drops, 12);
+	CHECK_EQUAL(readCircBufU16Reader(&newest, &entry), CIRCBUF_OK);
+	CHECK_EQUAL(entry, 23);
+	CHECK_EQUAL(newest.drops, 19);
+	CHECK_EQUAL(readCircBufU16Reader(&newest, &entry), CIRCBUF_EMPTY);
+}
+
+
+/* *****************************************************************************
+ * testReaderAcrossInit: entries a reader had not read when the buffer was
+ * initialised are dropped, and the reader carries on with the new entries.
+ */
+static void
+testReaderAcrossInit (void)
+{
+	circBufU16Reader_t reader;
+	uint16_t entry;
+	uint32_t i;
+
+	initCircBufU16Reader(&reader, &g_stream, CIRCBUF_SKIP_TO_OLDEST);
+	for (i = 1; i <= 5; i++) {
+		writeCircBufU16(&g_stream, i);
+	}
+	CHECK_EQUAL(readCircBufU16Reader(&reader, &entry), CIRCBUF_OK);
+	CHECK_EQUAL(entry, 1);
+
+	initCircBufU16(&g_stream);
+	CHECK_EQUAL(circBufU16ReaderLag(&reader), 4);
+	CHECK_EQUAL(readCircBufU16Reader(&reader, &entry), CIRCBUF_EMPTY);
+	CHECK_EQUAL(reader.drops, 4);
+
+	writeCircBufU16(&g_stream, 42);
+	CHECK_EQUAL(readCircBufU16Reader(&reader, &entry), CIRCBUF_OK);
+	CHECK_EQUAL(entry, 42);
+
+	// A reader attached after init starts empty, with no drops
+	initCircBufU16Reader(&reader, &g_stream, CIRCBUF_SKIP_TO_OLDEST);
+	CHECK_EQUAL(readCircBufU16Reader(&reader, &entry), CIRCBUF_EMPTY);
+	CHECK_EQUAL(reader.drops, 0);
+}
+
+
+int
+main (void)
+{
+	testWrap();
+	testMean();
+	testTypes();
+	testReaders();
+	testReaderAcrossInit();
+	return testReport("testCircBufStatic");
+}
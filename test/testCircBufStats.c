@@ -0,0 +1,80 @@
+/* *****************************************************************************
+ * testCircBufStats.c
+ *
+ * Host tests for circBufStats: the windowed minimum, maximum and variance are
+ * checked against a brute-force pass over the companion buffer after every
+ * sample.
+ *
+ * Hangwen Hu and Marc Katzef
+ * Last modified:  16.10.2026
+ */
+
+#include "testUtil.h"
+#include "circBufStatic.h"
+#include "circBufStats.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#define WINDOW_LOG2 4
+#define SAMPLES 200000
+
+CIRCBUF_STATIC_DEFINE(U16, g_window, WINDOW_LOG2);
+CIRCBUF_STATS_DEFINE(g_stats, WINDOW_LOG2);
+
+
+/* *****************************************************************************
+ * testAgainstBruteForce: random 12-bit samples, with runs of small values so
+ * the extremes leave the window often. The window is only partly full for the
+ * first samples.
+ */
+static void
+testAgainstBruteForce (void)
+{
+	uint32_t size = g_window.mask + 1;
+	uint32_t failures = 0;
+	uint32_t count;
+	uint32_t i;
+	uint32_t k;
+
+	CHECK_EQUAL(circBufStatsMin(&g_stats), 0);
+	CHECK_EQUAL(circBufStatsMax(&g_stats), 0);
+	CHECK_EQUAL(circBufStatsVariance(&g_stats), 0);
+
+	srand(3);
+	for (i = 0; i < SAMPLES; i++) {
+		uint16_t sample = (i % 1000 < 30) ? i % 7 : rand() & 0xFFF;
+		uint16_t replaced = writeCircBufU16(&g_window, sample);
+		uint32_t min = UINT32_MAX;
+		uint32_t max = 0;
+		uint64_t sum = 0;
+		uint64_t sumSquares = 0;
+
+		circBufStatsUpdate(&g_stats, sample, replaced);
+
+		count = (i + 1 < size) ? i + 1 : size;
+		for (k = 0; k < count; k++) {
+			uint32_t value = circBufU16Peek(&g_window, k);
+			if (value < min)
+				min = value;
+			if (value > max)
+				max = value;
+			sum += value;
+			sumSquares += (uint64_t)value * value;
+		}
+
+		if (circBufStatsMin(&g_stats) != min || circBufStatsMax(&g_stats) != max
+				|| circBufStatsVariance(&g_stats) != (count * sumSquares - sum * sum) / ((uint64_t)count * count)) {
+			failures++;
+		}
+	}
+	CHECK_EQUAL(failures, 0);
+}
+
+
+int
+main (void)
+{
+	testAgainstBruteForce();
+	return testReport("testCircBufStats");
+}
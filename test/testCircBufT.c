@@ -0,0 +1,289 @@
+/* *****************************************************************************
+ * testCircBufT.c
+ *
+ * Host tests for circBufT: the running sum behind circBufMean is checked
+ * against a full rescan of the data array, the single-producer/single-
+ * consumer queue against a producer on another thread, and the non-consuming
+ * peek, view and snapshot calls alone and against a concurrent writer.
+ *
+ * Hangwen Hu and Marc Katzef
+ * Last modified:  16.10.2026
+ */
+
+#include "testUtil.h"
+#include "circBufT.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define QUEUE_SIZE 64
+#define QUEUE_ENTRIES 2000000
+#define SNAPSHOT_SIZE 50
+#define SNAPSHOT_ROUNDS 200000
+
+static circBuf_t g_queue;
+static circBuf_t g_sharedBuffer;
+static volatile int g_stopWriter;
+
+/* *****************************************************************************
+ * rescanMean: returns the rounded mean of the data array, summed afresh.
+ */
+static uint32_t
+rescanMean (circBuf_t *buffer)
+{
+	uint64_t sum = 0;
+	uint32_t i;
+
+	for (i = 0; i < buffer->size; i++) {
+		sum += buffer->data[i];
+	}
+	return (2 * sum + buffer->size) / (2 * buffer->size);
+}
+
+
+/* *****************************************************************************
+ * testRunningMean: writes random 12-bit samples through several laps of
+ * buffers of various sizes, including sizes that are not powers of two.
+ */
+static void
+testRunningMean (void)
+{
+	static const uint32_t sizes[] = {1, 2, 3, 25, 64, 500};
+	circBuf_t buffer;
+	uint32_t s;
+	uint32_t i;
+
+	srand(1);
+	for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+		CHECK(initCircBuf(&buffer, sizes[s]) != NULL);
+		CHECK_EQUAL(circBufMean(&buffer), 0);
+		for (i = 0; i < 5 * sizes[s] + 7; i++) {
+			writeCircBuf(&buffer, rand() & 0xFFF);
+			CHECK_EQUAL(circBufMean(&buffer), rescanMean(&buffer));
+		}
+		freeCircBuf(&buffer);
+	}
+}
+
+
+/* *****************************************************************************
+ * testMeanLeavesReadIndex: circBufMean must not consume entries.
+ */
+static void
+testMeanLeavesReadIndex (void)
+{
+	circBuf_t buffer;
+	uint32_t i;
+
+	initCircBuf(&buffer, 8);
+	for (i = 1; i <= 8; i++) {
+		writeCircBuf(&buffer, i);
+	}
+	circBufMean(&buffer);
+	CHECK_EQUAL(buffer.rindex, 0);
+	CHECK_EQUAL(readCircBuf(&buffer), 1);
+	freeCircBuf(&buffer);
+}
+
+
+/* *****************************************************************************
+ * testQueueLimits: the queue holds size - 1 entries, refuses and counts writes
+ * when full and reads when empty, and keeps its count through wrap-around.
+ */
+static void
+testQueueLimits (void)
+{
+	circBuf_t buffer;
+	uint32_t entry = 0;
+	uint32_t i;
+
+	initCircBuf(&buffer, 4);
+	CHECK_EQUAL(tryReadCircBuf(&buffer, &entry), CIRCBUF_EMPTY);
+	CHECK_EQUAL(buffer.underruns, 1);
+	for (i = 1; i <= 3; i++) {
+		CHECK_EQUAL(tryWriteCircBuf(&buffer, i), CIRCBUF_OK);
+		CHECK_EQUAL(circBufCount(&buffer), i);
+	}
+	CHECK_EQUAL(tryWriteCircBuf(&buffer, 4), CIRCBUF_FULL);
+	CHECK_EQUAL(buffer.overruns, 1);
+	CHECK_EQUAL(circBufCount(&buffer), 3);
+
+	for (i = 1; i <= 10; i++) {
+		CHECK_EQUAL(tryReadCircBuf(&buffer, &entry), CIRCBUF_OK);
+		CHECK_EQUAL(entry, i);
+		CHECK_EQUAL(tryWriteCircBuf(&buffer, i + 3), CIRCBUF_OK);
+		CHECK_EQUAL(circBufCount(&buffer), 3);
+	}
+	for (i = 11; i <= 13; i++) {
+		CHECK_EQUAL(tryReadCircBuf(&buffer, &entry), CIRCBUF_OK);
+		CHECK_EQUAL(entry, i);
+	}
+	CHECK_EQUAL(circBufCount(&buffer), 0);
+	CHECK_EQUAL(tryReadCircBuf(&buffer, &entry), CIRCBUF_EMPTY);
+	CHECK_EQUAL(buffer.underruns, 2);
+	CHECK_EQUAL(buffer.overruns, 1);
+	freeCircBuf(&buffer);
+}
+
+
+/* *****************************************************************************
+ * producerThread: stands in for the ISR, queueing 1 to QUEUE_ENTRIES in order
+ * and retrying each write that finds the queue full. Both sides yield when
+ * they cannot proceed, so the test also runs quickly on a single core.
+ */
+static void *
+producerThread (void *arg)
+{
+	uint32_t next = 1;
+
+	while (next <= QUEUE_ENTRIES) {
+		if (tryWriteCircBuf(&g_queue, next) == CIRCBUF_OK) {
+			next++;
+		} else {
+			sched_yield();
+		}
+	}
+	return NULL;
+}
+
+
+/* *****************************************************************************
+ * testQueueConcurrent: every entry queued by a producer on another thread is
+ * read once, in order, without either side disabling anything, and the count
+ * never exceeds the queue's capacity. A small queue keeps both the full and
+ * empty paths busy.
+ */
+static void
+testQueueConcurrent (void)
+{
+	pthread_t producer;
+	uint32_t expected = 1;
+	uint32_t wrong = 0;
+	uint32_t overfull = 0;
+	uint32_t entry;
+
+	initCircBuf(&g_queue, QUEUE_SIZE);
+	CHECK(pthread_create(&producer, NULL, producerThread, NULL) == 0);
+	while (expected <= QUEUE_ENTRIES) {
+		if (circBufCount(&g_queue) > QUEUE_SIZE - 1) {
+			overfull++;
+		}
+		if (tryReadCircBuf(&g_queue, &entry) == CIRCBUF_OK) {
+			if (entry != expected) {
+				wrong++;
+			}
+			expected++;
+		} else {
+			sched_yield();
+		}
+	}
+	pthread_join(producer, NULL);
+
+	CHECK_EQUAL(wrong, 0);
+	CHECK_EQUAL(overfull, 0);
+	CHECK_EQUAL(circBufCount(&g_queue), 0);
+	CHECK(g_queue.overruns > 0);
+	CHECK(g_queue.underruns > 0);
+	freeCircBuf(&g_queue);
+}
+
+
+/* *****************************************************************************
+ * testPeekAndView: peeks and views of a wrapped buffer give the newest and
+ * oldest entries in order, and leave rindex alone.
+ */
+static void
+testPeekAndView (void)
+{
+	circBufView_t view;
+	circBuf_t buffer;
+	uint32_t expected;
+	uint32_t i;
+
+	initCircBuf(&buffer, 5);
+	for (i = 1; i <= 7; i++) {
+		writeCircBuf(&buffer, i);
+	}
+	for (i = 0; i < 5; i++) {
+		CHECK_EQUAL(circBufPeek(&buffer, i), 7 - i);
+	}
+
+	circBufView(&buffer, &view);
+	CHECK_EQUAL(view.firstLength + view.secondLength, 5);
+	expected = 3;
+	for (i = 0; i < view.firstLength; i++) {
+		CHECK_EQUAL(view.first[i], expected++);
+	}
+	for (i = 0; i < view.secondLength; i++) {
+		CHECK_EQUAL(view.second[i], expected++);
+	}
+	CHECK_EQUAL(buffer.rindex, 0);
+	freeCircBuf(&buffer);
+}
+
+
+/* *****************************************************************************
+ * writerThread: stands in for the ADC ISR, writing an increasing sequence.
+ */
+static void *
+writerThread (void *arg)
+{
+	uint32_t value;
+
+	for (value = 1; !g_stopWriter; value++) {
+		writeCircBuf(&g_sharedBuffer, value);
+	}
+	return NULL;
+}
+
+
+/* *****************************************************************************
+ * testSnapshotWhileWriting: every snapshot taken during concurrent writes
+ * must be a run of consecutive values, i.e. no copy mixes two buffer states.
+ */
+static void
+testSnapshotWhileWriting (void)
+{
+	uint32_t copy[SNAPSHOT_SIZE];
+	pthread_t writer;
+	uint32_t torn = 0;
+	uint32_t count;
+	uint32_t round;
+	uint32_t i;
+
+	initCircBuf(&g_sharedBuffer, SNAPSHOT_SIZE);
+	g_stopWriter = 0;
+	CHECK(pthread_create(&writer, NULL, writerThread, NULL) == 0);
+
+	for (round = 0; round < SNAPSHOT_ROUNDS; round++) {
+		count = 1 + round % SNAPSHOT_SIZE;
+		CHECK_EQUAL(circBufSnapshot(&g_sharedBuffer, copy, count), count);
+		for (i = 1; i < count; i++) {
+			// Zeroes are entries not yet written since init
+			if (copy[i - 1] != 0 && copy[i] != copy[i - 1] + 1) {
+				torn++;
+			}
+		}
+	}
+
+	g_stopWriter = 1;
+	pthread_join(writer, NULL);
+	CHECK_EQUAL(torn, 0);
+	CHECK_EQUAL(g_sharedBuffer.rindex, 0);
+	freeCircBuf(&g_sharedBuffer);
+}
+
+
+int
+main (void)
+{
+	testRunningMean();
+	testMeanLeavesReadIndex();
+	testQueueLimits();
+	testQueueConcurrent();
+	testPeekAndView();
+	testSnapshotWhileWriting();
+	return testReport("testCircBufT");
+}
@@ -0,0 +1,224 @@
+/* *****************************************************************************
+ * testClimbRate.c
+ *
+ * Host tests for the altimeter's alpha-beta climb rate, against the fake ADC:
+ * its delay behind a sinusoidal altitude and its rise after the start of a
+ * climb, each compared with differencing getCurrentAltitudeTenths, which
+ * follows the mean of the whole buffer.
+ *
+ * Hangwen Hu and Marc Katzef
+ * Last modified:  16.10.2026
+ */
+
+#include "testUtil.h"
+#include "fakeTiva.h"
+#include "altimeter.h"
+
+#include <math.h>
+#include <stdint.h>
+
+#define GROUND 3000 // ADC value at 0%
+#define HOVER (GROUND - 600) // ADC value about which the altitude moves
+#define ALT_RANGE ((uint32_t)(ALTITUDE_RANGE_VOLTS * (1 << ADC_WIDTH_BITS) / ADC_RANGE_VOLTS))
+#define TENTHS_PER_COUNT (1000.0 / ALT_RANGE)
+
+#define SINE_PERIOD 400 // samples
+#define SINE_AMPLITUDE 300.0 // ADC counts
+#define SINE_SAMPLES (4 * SINE_PERIOD)
+#define MAX_LAG 40 // samples
+#define RAMP_SLOPE 2 // ADC counts per sample
+#define RAMP_SAMPLES 200
+#define SETTLE_SAMPLES (8 * BUF_SIZE) // at HOVER, before each run
+// Delay of the alpha-beta rate behind a slow change, alpha / beta samples
+#define ALPHA_BETA_DELAY (1 << (ALT_RATE_BETA_SHIFT - ALT_RATE_ALPHA_SHIFT))
+
+static uint32_t g_conversion; // conversions made by the fake ADC since reset
+
+/* *****************************************************************************
+ * sineLevel: the ADC value of conversion n, an altitude swinging about
+ * HOVER.
+ */
+static uint32_t
+sineLevel (void)
+{
+	double phase = 2 * M_PI * g_conversion++ / SINE_PERIOD;
+
+	return (uint32_t)lround(HOVER - SINE_AMPLITUDE * sin(phase));
+}
+
+
+/* *****************************************************************************
+ * sineRate: the true climb rate at sample n of sineLevel, in tenths of a
+ * percent per second.
+ */
+static double
+sineRate (int32_t n)
+{
+	double phase = 2 * M_PI * n / SINE_PERIOD;
+
+	return SINE_AMPLITUDE * 2 * M_PI / SINE_PERIOD * cos(phase) * ALT_SAMPLE_RATE
+			* TENTHS_PER_COUNT;
+}
+
+
+/* *****************************************************************************
+ * rampLevel: the ADC value of conversion n, climbing from HOVER at RAMP_SLOPE
+ * counts per sample.
+ */
+static uint32_t
+rampLevel (void)
+{
+	return HOVER - RAMP_SLOPE * g_conversion++;
+}
+
+
+/* *****************************************************************************
+ * restartAt: initialises the altimeter, calibrates it to GROUND and lets both
+ * estimates settle at HOVER, then switches the fake ADC to source. The
+ * conversion already triggered is still at HOVER, so sample n of the source is
+ * stored by poll n + 1.
+ */
+static void
+restartAt (uint32_t (*source)(void))
+{
+	uint32_t i;
+
+	fakeAdcSetSource(NULL);
+	fakeAdcSetLevel(GROUND);
+	initAltimeter();
+	for (i = 0; i < BUF_SIZE; i++) {
+		updateAltitude();
+	}
+	CHECK(altimeterCalibrated_p());
+	fakeAdcSetLevel(HOVER);
+	for (i = 0; i < SETTLE_SAMPLES; i++) {
+		updateAltitude();
+	}
+	g_conversion = 0;
+	fakeAdcSetSource(source);
+	updateAltitude();
+}
+
+
+/* *****************************************************************************
+ * delayOf: returns the lag, in samples, at which estimate[] correlates best
+ * with the true rate, over the last two periods.
+ */
+static int32_t
+delayOf (const double *estimate)
+{
+	double best = -INFINITY;
+	int32_t bestLag = -1;
+	int32_t lag;
+	int32_t n;
+
+	for (lag = 0; lag <= MAX_LAG; lag++) {
+		double correlation = 0;
+
+		for (n = SINE_SAMPLES - 2 * SINE_PERIOD; n < SINE_SAMPLES; n++) {
+			correlation += estimate[n] * sineRate(n - lag);
+		}
+		if (correlation > best) {
+			best = correlation;
+			bestLag = lag;
+		}
+	}
+	return bestLag;
+}
+
+
+/* *****************************************************************************
+ * testSineDelay: the alpha-beta rate follows a slow sinusoidal altitude about
+ * ALPHA_BETA_DELAY samples late. Differencing the mean of the buffer lags by
+ * half the buffer, (BUF_SIZE - 1) / 2 samples.
+ */
+static void
+testSineDelay (void)
+{
+	static double alphaBeta[SINE_SAMPLES];
+	static double differenced[SINE_SAMPLES];
+	int32_t previous;
+	int32_t tenths;
+	int32_t n;
+
+	restartAt(sineLevel);
+	previous = getCurrentAltitudeTenths();
+	for (n = 0; n < SINE_SAMPLES; n++) {
+		updateAltitude();
+		tenths = getCurrentAltitudeTenths();
+		alphaBeta[n] = getAltitudeClimbRate();
+		differenced[n] = (double)(tenths - previous) * ALT_SAMPLE_RATE;
+		previous = tenths;
+	}
+
+	int32_t alphaBetaDelay = delayOf(alphaBeta);
+	int32_t differencedDelay = delayOf(differenced);
+
+	printf("climb rate delay: alpha-beta %d samples, differenced mean %d samples\n",
+			alphaBetaDelay, differencedDelay);
+	CHECK(alphaBetaDelay >= ALPHA_BETA_DELAY - 1);
+	CHECK(alphaBetaDelay <= ALPHA_BETA_DELAY + 1);
+	CHECK(alphaBetaDelay < differencedDelay);
+	CHECK(differencedDelay >= (BUF_SIZE - 1) / 2 - 1);
+	CHECK(differencedDelay <= (BUF_SIZE - 1) / 2 + 2);
+}
+
+
+/* *****************************************************************************
+ * samplesTo90: returns the first sample at which estimate[] reaches 90% of
+ * target and stays there.
+ */
+static int32_t
+samplesTo90 (const double *estimate, double target)
+{
+	int32_t n = RAMP_SAMPLES;
+
+	while (n > 0 && estimate[n - 1] >= 0.9 * target) {
+		n--;
+	}
+	return n;
+}
+
+
+/* *****************************************************************************
+ * testRampRise: after the start of a steady climb, the alpha-beta rate reaches
+ * 90% of the climb rate in fewer samples than differencing the mean, and both
+ * settle on it.
+ */
+static void
+testRampRise (void)
+{
+	static double alphaBeta[RAMP_SAMPLES];
+	static double differenced[RAMP_SAMPLES];
+	double target = RAMP_SLOPE * ALT_SAMPLE_RATE * TENTHS_PER_COUNT;
+	int32_t previous;
+	int32_t tenths;
+	int32_t n;
+
+	restartAt(rampLevel);
+	previous = getCurrentAltitudeTenths();
+	for (n = 0; n < RAMP_SAMPLES; n++) {
+		updateAltitude();
+		tenths = getCurrentAltitudeTenths();
+		alphaBeta[n] = getAltitudeClimbRate();
+		differenced[n] = (double)(tenths - previous) * ALT_SAMPLE_RATE;
+		previous = tenths;
+	}
+
+	int32_t alphaBetaRise = samplesTo90(alphaBeta, target);
+	int32_t differencedRise = samplesTo90(differenced, target);
+
+	printf("climb rate rise to 90%%: alpha-beta %d samples, differenced mean %d samples\n",
+			alphaBetaRise, differencedRise);
+	CHECK(alphaBetaRise < differencedRise);
+	CHECK(fabs(alphaBeta[RAMP_SAMPLES - 1] - target) <= 0.02 * target);
+}
+
+
+int
+main (void)
+{
+	testSineDelay();
+	testRampRise();
+	return testReport("testClimbRate");
+}
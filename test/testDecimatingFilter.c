@@ -0,0 +1,215 @@
+/* *****************************************************************************
+ * testDecimatingFilter.c
+ *
+ * Host tests for the CIC decimator and IIR filter: primed stages hold a steady
+ * input exactly from the first output, a first order CIC is a block mean, the
+ * altitude low-pass settles on a step without ringing, and the gain of the
+ * altitude pipeline matches its design across the band.
+ *
+ * Hangwen Hu and Marc Katzef
+ * Last modified:  16.10.2026
+ */
+
+#include "testUtil.h"
+#include "decimatingFilter.h"
+
+#include <math.h>
+#include <stdint.h>
+
+#define STEADY_INPUT 40000 // 2500 ADC counts with 4 fractional bits
+
+// Second order Butterworth low-pass, as used for altitude
+#define B0 IIR_COEFF(0.0674553)
+#define B1 IIR_COEFF(0.1349105)
+#define B2 IIR_COEFF(0.0674553)
+#define A1 IIR_COEFF(-1.1429805)
+#define A2 IIR_COEFF(0.4128016)
+
+// Altitude pipeline: 200 Hz input, third order CIC decimating by 2, then the
+// low-pass above at 100 Hz with a 10 Hz cutoff
+#define INPUT_RATE 200.0
+#define CIC_ORDER 3
+#define CIC_DECIMATION_LOG2 1
+#define OUTPUT_RATE (INPUT_RATE / (1 << CIC_DECIMATION_LOG2))
+#define CUTOFF 10.0
+#define SINE_OFFSET 32000.0 // 2000 ADC counts with 4 fractional bits
+#define SINE_AMPLITUDE 16000.0
+#define SETTLE_OUTPUTS 200
+#define MEASURE_OUTPUTS 1000 // a whole number of cycles of every tested frequency
+
+
+/* *****************************************************************************
+ * testPrimedCic: every order and decimation whose gain fits in 32 bits with
+ * the input gives the steady input from its first output.
+ */
+static void
+testPrimedCic (void)
+{
+	cicDecimator_t cic;
+	uint32_t failures = 0;
+	uint32_t outputs;
+	uint32_t order;
+	uint32_t decimationLog2;
+	int32_t output;
+	uint32_t i;
+
+	for (order = 1; order <= CIC_MAX_ORDER; order++) {
+		for (decimationLog2 = 0; order * decimationLog2 <= 15; decimationLog2++) {
+			initCicDecimator(&cic, order, decimationLog2, STEADY_INPUT);
+			outputs = 0;
+			for (i = 0; i < 100; i++) {
+				if (cicDecimatorUpdate(&cic, STEADY_INPUT, &output)) {
+					outputs++;
+					if (output != STEADY_INPUT) {
+						failures++;
+					}
+				}
+			}
+			CHECK_EQUAL(outputs, 100 >> decimationLog2);
+		}
+	}
+	CHECK_EQUAL(failures, 0);
+}
+
+
+/* *****************************************************************************
+ * testFirstOrderCic: a first order CIC outputs the mean of each block.
+ */
+static void
+testFirstOrderCic (void)
+{
+	cicDecimator_t cic;
+	int32_t output;
+	int32_t i;
+
+	initCicDecimator(&cic, 1, 2, 0);
+	for (i = 0; i < 8; i++) {
+		if (cicDecimatorUpdate(&cic, i * 4, &output)) {
+			CHECK_EQUAL(output, 4 * i - 6); // mean of 4 * (i - 3) ... 4 * i
+		}
+	}
+}
+
+
+/* *****************************************************************************
+ * testIirStep: a primed low-pass holds its input, then settles on a step to
+ * within one count, with the small overshoot of a Butterworth response.
+ */
+static void
+testIirStep (void)
+{
+	iirFilter_t filter;
+	int32_t target = STEADY_INPUT - 8000;
+	int32_t output = 0;
+	int32_t lowest = STEADY_INPUT;
+	uint32_t i;
+
+	initIirFilter(&filter, B0, B1, B2, A1, A2, STEADY_INPUT);
+	for (i = 0; i < 50; i++) {
+		CHECK_EQUAL(iirFilterUpdate(&filter, STEADY_INPUT), STEADY_INPUT);
+	}
+	for (i = 0; i < 200; i++) {
+		output = iirFilterUpdate(&filter, target);
+		if (output < lowest)
+			lowest = output;
+	}
+	CHECK(output >= target - 1 && output <= target + 1);
+	CHECK(lowest >= target - 8000 / 20);
+}
+
+
+/* *****************************************************************************
+ * designedGainDb: the gain in dB the altitude pipeline is designed to have at
+ * frequency (below OUTPUT_RATE / 2): a CIC of CIC_ORDER sinc stages, then a
+ * second order Butterworth low-pass from the bilinear transform.
+ */
+static double
+designedGainDb (double frequency)
+{
+	double decimation = 1 << CIC_DECIMATION_LOG2;
+	double cic = sin(M_PI * frequency * decimation / INPUT_RATE)
+			/ (decimation * sin(M_PI * frequency / INPUT_RATE));
+	double ratio = tan(M_PI * frequency / OUTPUT_RATE) / tan(M_PI * CUTOFF / OUTPUT_RATE);
+
+	return 20 * log10(pow(fabs(cic), CIC_ORDER)) - 10 * log10(1 + pow(ratio, 4));
+}
+
+
+/* *****************************************************************************
+ * measuredGainDb: drives a sinusoid of the given frequency through a primed
+ * altitude pipeline, and returns its gain in dB from the output amplitude,
+ * fitted over MEASURE_OUTPUTS outputs once the start-up has died away.
+ */
+static double
+measuredGainDb (double frequency)
+{
+	cicDecimator_t cic;
+	iirFilter_t filter;
+	double sinSum = 0;
+	double cosSum = 0;
+	uint32_t outputs = 0;
+	uint32_t input;
+	int32_t decimated;
+
+	initCicDecimator(&cic, CIC_ORDER, CIC_DECIMATION_LOG2, SINE_OFFSET);
+	initIirFilter(&filter, B0, B1, B2, A1, A2, SINE_OFFSET);
+	for (input = 0; outputs < SETTLE_OUTPUTS + MEASURE_OUTPUTS; input++) {
+		double phase = 2 * M_PI * frequency * input / INPUT_RATE;
+		int32_t sample = lround(SINE_OFFSET + SINE_AMPLITUDE * sin(phase));
+
+		if (cicDecimatorUpdate(&cic, sample, &decimated)) {
+			int32_t output = iirFilterUpdate(&filter, decimated);
+
+			if (outputs >= SETTLE_OUTPUTS) {
+				sinSum += (output - SINE_OFFSET) * sin(phase);
+				cosSum += (output - SINE_OFFSET) * cos(phase);
+			}
+			outputs++;
+		}
+	}
+	return 20 * log10(2 * hypot(sinSum, cosSum) / MEASURE_OUTPUTS / SINE_AMPLITUDE);
+}
+
+
+/* *****************************************************************************
+ * testFrequencyResponse: the pipeline's gain follows its design, within the
+ * rounding of its coefficients and arithmetic: flat in the passband, about
+ * -3 dB at the cutoff (a little lower with the CIC droop), and well
+ * attenuated towards the decimated Nyquist frequency.
+ */
+static void
+testFrequencyResponse (void)
+{
+	static const double frequencies[] = {1, 2, 5, 8, 10, 12, 15, 20, 25, 30, 35, 40, 45};
+	double worst = 0;
+	uint32_t i;
+
+	for (i = 0; i < sizeof(frequencies) / sizeof(frequencies[0]); i++) {
+		double measured = measuredGainDb(frequencies[i]);
+		double designed = designedGainDb(frequencies[i]);
+
+		// Below -40 dB the output is only a few units, so rounding dominates
+		if (designed > -40) {
+			worst = fmax(worst, fabs(measured - designed));
+		}
+	}
+	CHECK(worst < 0.05);
+
+	CHECK(fabs(measuredGainDb(1)) < 0.05);
+	CHECK(fabs(measuredGainDb(3)) < 0.1);
+	CHECK(fabs(measuredGainDb(CUTOFF) + 3.0) < 0.5);
+	CHECK(measuredGainDb(30) < -20);
+	CHECK(measuredGainDb(40) < -40);
+	CHECK(measuredGainDb(45) < -50);
+}
+
+
+int
+main (void)
+{
+	testPrimedCic();
+	testFirstOrderCic();
+	testIirStep();
+	testFrequencyResponse();
+	return testReport("testDecimatingFilter");
+}
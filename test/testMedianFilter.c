@@ -0,0 +1,105 @@
+/* *****************************************************************************
+ * testMedianFilter.c
+ *
+ * Host tests for medianFilter: the sliding median is checked against a sort of
+ * the whole window after every sample.
+ *
+ * Hangwen Hu and Marc Katzef
+ * Last modified:  16.10.2026
+ */
+
+#include "testUtil.h"
+#include "circBufStatic.h"
+#include "medianFilter.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SAMPLES 50000
+
+CIRCBUF_STATIC_DEFINE(U16, g_oddWindow, 0);
+CIRCBUF_STATIC_DEFINE(U16, g_window, 5);
+MEDIAN_FILTER_DEFINE(g_singleMedian, 0);
+MEDIAN_FILTER_DEFINE(g_median, 5);
+
+
+/* *****************************************************************************
+ * compareU16: qsort comparison of two uint16_t values.
+ */
+static int
+compareU16 (const void *a, const void *b)
+{
+	return *(const uint16_t *)a - *(const uint16_t *)b;
+}
+
+
+/* *****************************************************************************
+ * sortedMedian: returns the median of the window from a sorted copy, with the
+ * rounding medianFilterValue documents.
+ */
+static uint16_t
+sortedMedian (circBufU16_t *window)
+{
+	uint16_t sorted[1u << 5];
+	uint32_t size = window->mask + 1;
+
+	memcpy(sorted, window->data, size * sizeof(sorted[0]));
+	qsort(sorted, size, sizeof(sorted[0]), compareU16);
+	if (size & 1)
+		return sorted[size / 2];
+	return (sorted[size / 2 - 1] + sorted[size / 2] + 1) / 2;
+}
+
+
+/* *****************************************************************************
+ * testAgainstSort: random 12-bit samples, with runs of repeated values since
+ * ties are the awkward case for the heaps.
+ */
+static void
+testAgainstSort (void)
+{
+	uint32_t failures = 0;
+	uint32_t i;
+
+	initMedianFilter(&g_median, &g_window);
+	CHECK_EQUAL(medianFilterValue(&g_median), 0);
+
+	srand(4);
+	for (i = 0; i < SAMPLES; i++) {
+		uint16_t sample = (i % 500 < 100) ? 2000 : rand() & 0xFFF;
+
+		writeCircBufU16(&g_window, sample);
+		medianFilterUpdate(&g_median);
+		if (medianFilterValue(&g_median) != sortedMedian(&g_window)) {
+			failures++;
+		}
+	}
+	CHECK_EQUAL(failures, 0);
+}
+
+
+/* *****************************************************************************
+ * testSingleEntry: a one-entry window gives the newest sample.
+ */
+static void
+testSingleEntry (void)
+{
+	uint32_t i;
+
+	initMedianFilter(&g_singleMedian, &g_oddWindow);
+	for (i = 1; i <= 5; i++) {
+		writeCircBufU16(&g_oddWindow, i * 100);
+		medianFilterUpdate(&g_singleMedian);
+		CHECK_EQUAL(medianFilterValue(&g_singleMedian), i * 100);
+	}
+}
+
+
+int
+main (void)
+{
+	testAgainstSort();
+	testSingleEntry();
+	return testReport("testMedianFilter");
+}
@@ -0,0 +1,173 @@
+/* *****************************************************************************
+ * testPid.c
+ *
+ * Host tests for pidController in the number type selected by PID_NUMERIC
+ * (the Makefile builds one program per type): pidUpdate against a double
+ * reference of the same equations, saturation of the fixed point integrator,
+ * and pidBatchUpdate against pidDiscreteUpdate.
+ *
+ * Hangwen Hu and Marc Katzef
+ * Last modified:  16.10.2026
+ */
+
+#include "testUtil.h"
+#include "pidController.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define STEPS 10000
+#define DELTA_T 0.01
+#define KP 1.0
+#define KI 0.5
+#define KD 0.2
+
+// Largest difference from the reference, in output units. The fixed point
+// difference is mostly from deltaT and the gains rounded to Q16.16.
+#if PID_NUMERIC == PID_NUMERIC_FIXED
+#define PID_NAME "testPidFixed"
+#define TOLERANCE 0.05
+#define TO_DOUBLE(x) ((double)(x) / (1 << PID_FRAC_BITS))
+#elif PID_NUMERIC == PID_NUMERIC_FLOAT
+#define PID_NAME "testPidFloat"
+#define TOLERANCE 1e-3
+#define TO_DOUBLE(x) ((double)(x))
+#else
+#define PID_NAME "testPidDouble"
+#define TOLERANCE 1e-9
+#define TO_DOUBLE(x) ((double)(x))
+#endif
+
+/* *****************************************************************************
+ * Reference controller, in double, as pidController computed before
+ * PID_NUMERIC
+ */
+typedef struct {
+	double errorIntegrated;
+} referencePid_t;
+
+static double
+referenceUpdate (referencePid_t *pid, double error, double errorDerivative)
+{
+	pid->errorIntegrated += error * DELTA_T;
+	return error * KP + pid->errorIntegrated * KI + errorDerivative * KD;
+}
+
+
+/* *****************************************************************************
+ * testDifferenced: pidUpdate follows the reference, with the derivative taken
+ * by differencing the error. Steps of the error are kept small, since the
+ * difference is divided by deltaT and so magnifies any rounding of it.
+ */
+static void
+testDifferenced (void)
+{
+	pidController_t controller;
+	referencePid_t reference = {0};
+	pidReal_t tenth = PID_CONST(0.1);
+	int32_t error = 0;
+	double worst = 0;
+	uint32_t i;
+
+	initPidController(&controller, PID_CONST(KP), PID_CONST(KI), PID_CONST(KD));
+	srand(24);
+	for (i = 0; i < STEPS; i++) {
+		double previous = error * 0.1;
+
+		error += rand() % 5 - 2 - error / 64; // Wanders, about zero
+		double control = TO_DOUBLE(pidUpdate(&controller, PID_SCALE_INT(error, tenth),
+				PID_CONST(DELTA_T)));
+		double expected = referenceUpdate(&reference, error * 0.1,
+				(error * 0.1 - previous) / DELTA_T);
+
+		worst = fmax(worst, fabs(control - expected));
+	}
+	CHECK(worst <= TOLERANCE);
+}
+
+
+/* *****************************************************************************
+ * testSaturation: a large error held for a long time keeps the output
+ * positive. In fixed point, the integrator stops at its largest value rather
+ * than wrapping negative.
+ */
+static void
+testSaturation (void)
+{
+	pidController_t controller;
+	pidReal_t control = 0;
+	uint32_t i;
+
+	initPidController(&controller, PID_CONST(KP), PID_CONST(KI), PID_CONST(KD));
+	for (i = 0; i < 200000; i++) {
+		control = pidUpdate(&controller, PID_FROM_INT(10000), PID_CONST(1.0));
+	}
+	CHECK(control > 0);
+#if PID_NUMERIC == PID_NUMERIC_FIXED
+	CHECK_EQUAL(controller.errorIntegrated, PID_MAX);
+#endif
+}
+
+
+/* *****************************************************************************
+ * testBatch: a batch gives exactly the outputs of the same controllers
+ * updated one at a time with pidDiscreteUpdate, each with its own gains and
+ * limits, including while saturated. Controllers past the count are left
+ * alone.
+ */
+static void
+testBatch (void)
+{
+	static pidBatch_t batch;
+	pidDiscrete_t single[PID_BATCH_MAX];
+	pidReal_t error[PID_BATCH_MAX];
+	pidReal_t rate[PID_BATCH_MAX];
+	pidReal_t control[PID_BATCH_MAX];
+	uint32_t mismatches = 0;
+	uint32_t step;
+	uint32_t i;
+
+	initPidBatch(&batch, PID_BATCH_MAX + 1);
+	CHECK_EQUAL(batch.count, PID_BATCH_MAX);
+	initPidBatch(&batch, PID_BATCH_MAX - 1);
+	for (i = 0; i < PID_BATCH_MAX - 1; i++) {
+		pidReal_t Kp = PID_CONST(KP) + PID_SCALE_INT(i, PID_CONST(0.25));
+		pidReal_t Ki = PID_CONST(KI) + PID_SCALE_INT(i, PID_CONST(0.125));
+		pidReal_t Kd = PID_CONST(KD) + PID_SCALE_INT(i, PID_CONST(0.05));
+		pidReal_t outputMin = PID_FROM_INT(2 + (int32_t)i);
+		pidReal_t outputMax = PID_FROM_INT(98 - (int32_t)i);
+
+		setPidBatchController(&batch, i, Kp, Ki, Kd, PID_CONST(0.02), PID_CONST(0.6),
+				PID_CONST(DELTA_T), outputMin, outputMax);
+		initPidDiscrete(&single[i], Kp, Ki, Kd, PID_CONST(0.02), PID_CONST(0.6),
+				PID_CONST(DELTA_T), outputMin, outputMax);
+	}
+
+	srand(25);
+	control[PID_BATCH_MAX - 1] = PID_FROM_INT(-1);
+	for (step = 0; step < 2000; step++) {
+		for (i = 0; i < PID_BATCH_MAX; i++) {
+			error[i] = PID_FROM_INT(rand() % 200 - 100);
+			rate[i] = PID_FROM_INT(rand() % 20 - 10);
+		}
+		pidBatchUpdate(&batch, error, rate, control);
+		for (i = 0; i < PID_BATCH_MAX - 1; i++) {
+			if (control[i] != pidDiscreteUpdate(&single[i], error[i], rate[i])) {
+				mismatches++;
+			}
+		}
+	}
+	CHECK_EQUAL(mismatches, 0);
+	CHECK_EQUAL(control[PID_BATCH_MAX - 1], PID_FROM_INT(-1));
+}
+
+
+int
+main (void)
+{
+	testDifferenced();
+	testSaturation();
+	testBatch();
+	return testReport(PID_NAME);
+}
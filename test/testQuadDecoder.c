@@ -0,0 +1,142 @@
+/* *****************************************************************************
+ * testQuadDecoder.c
+ *
+ * Host tests for quadDecoder with synthetic edge sequences: every transition
+ * against the Gray code order, whole turns each way, contact bounce and
+ * illegal transitions.
+ *
+ * Hangwen Hu and Marc Katzef
+ * Last modified:  16.10.2026
+ */
+
+#include "testUtil.h"
+#include "quadDecoder.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+// Clockwise order of the AB states
+static const uint32_t g_clockwise[4] = {
+	QUAD_STATE(0, 0), QUAD_STATE(0, 1), QUAD_STATE(1, 1), QUAD_STATE(1, 0)
+};
+
+/* *****************************************************************************
+ * grayPosition: returns the position of an AB state in the clockwise order.
+ */
+static uint32_t
+grayPosition (uint32_t state)
+{
+	uint32_t i;
+
+	for (i = 0; i < 4; i++) {
+		if (g_clockwise[i] == state)
+			return i;
+	}
+	return 0;
+}
+
+
+/* *****************************************************************************
+ * testEveryTransition: one step forward counts +1, one step back -1, no change
+ * 0, and two steps (both channels changed) 0 and one illegal transition.
+ */
+static void
+testEveryTransition (void)
+{
+	quadDecoder_t decoder;
+	uint32_t from;
+	uint32_t to;
+
+	for (from = 0; from < 4; from++) {
+		for (to = 0; to < 4; to++) {
+			uint32_t steps = (grayPosition(to) - grayPosition(from)) & 3;
+
+			initQuadDecoder(&decoder, from);
+			CHECK_EQUAL(quadDecoderUpdate(&decoder, to), steps == 1 ? 1 : steps == 3 ? -1 : 0);
+			CHECK_EQUAL(decoder.illegalCount, steps == 2);
+			CHECK_EQUAL(decoder.state, to);
+		}
+	}
+}
+
+
+/* *****************************************************************************
+ * testTurns: whole turns each way count four per cycle.
+ */
+static void
+testTurns (void)
+{
+	quadDecoder_t decoder;
+	int32_t count = 0;
+	uint32_t i;
+
+	initQuadDecoder(&decoder, g_clockwise[0]);
+	for (i = 1; i <= 4 * 100; i++) {
+		count += quadDecoderUpdate(&decoder, g_clockwise[i & 3]);
+	}
+	CHECK_EQUAL(count, 400);
+	for (i = 4 * 100 + 4 * 30; i > 0; i--) {
+		count += quadDecoderUpdate(&decoder, g_clockwise[(i - 1) & 3]);
+	}
+	CHECK_EQUAL(count, -120);
+	CHECK_EQUAL(decoder.illegalCount, 0);
+}
+
+
+/* *****************************************************************************
+ * testBounce: a channel bouncing about one edge nets zero, and repeated states
+ * (e.g. an interrupt for an edge already seen) count nothing.
+ */
+static void
+testBounce (void)
+{
+	quadDecoder_t decoder;
+	int32_t count = 0;
+	uint32_t i;
+
+	initQuadDecoder(&decoder, QUAD_STATE(0, 0));
+	srand(17);
+	for (i = 0; i < 1001; i++) {
+		count += quadDecoderUpdate(&decoder, (rand() & 1) ? QUAD_STATE(0, 1) : QUAD_STATE(0, 0));
+	}
+	count += quadDecoderUpdate(&decoder, QUAD_STATE(0, 0));
+	CHECK_EQUAL(count, 0);
+	CHECK_EQUAL(decoder.illegalCount, 0);
+}
+
+
+/* *****************************************************************************
+ * testMissedEdges: sampling a fast clockwise turn every other state skips
+ * edges; each skip is counted as illegal rather than guessed.
+ */
+static void
+testMissedEdges (void)
+{
+	quadDecoder_t decoder;
+	int32_t count = 0;
+	uint32_t i;
+
+	initQuadDecoder(&decoder, g_clockwise[0]);
+	for (i = 1; i <= 8; i++) {
+		count += quadDecoderUpdate(&decoder, g_clockwise[i & 3]);
+	}
+	for (i = 10; i <= 20; i += 2) {
+		count += quadDecoderUpdate(&decoder, g_clockwise[i & 3]);
+	}
+	CHECK_EQUAL(count, 8);
+	CHECK_EQUAL(decoder.illegalCount, 6);
+
+	initQuadDecoder(&decoder, g_clockwise[0]);
+	CHECK_EQUAL(decoder.illegalCount, 0);
+}
+
+
+int
+main (void)
+{
+	testEveryTransition();
+	testTurns();
+	testBounce();
+	testMissedEdges();
+	return testReport("testQuadDecoder");
+}
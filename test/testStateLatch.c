@@ -0,0 +1,177 @@
+/* *****************************************************************************
+ * testStateLatch.c
+ *
+ * Host tests for stateLatch: sequence counts, reads that preempt a publish,
+ * and readers on other threads against a writer publishing as fast as it can.
+ *
+ * Hangwen Hu and Marc Katzef
+ * Last modified:  16.10.2026
+ */
+
+#include "testUtil.h"
+#include "stateLatch.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#define LATCH_PUBLISHES 2000000
+#define LATCH_READERS 2
+
+static stateLatch_t g_sharedLatch;
+static volatile int g_stopReaders;
+
+/* *****************************************************************************
+ * stateFor: fills state with every field set from n, so a state mixing two
+ * publishes is easy to spot.
+ */
+static void
+stateFor (flightState_t *state, uint32_t n)
+{
+	state->timestamp = n;
+	state->altitude = n;
+	state->altitudeTenths = n * 10;
+	state->altitudeRate = -(int32_t)n;
+	state->yaw = n;
+	state->yawRate = n * 3;
+	state->targetAltitude = n + 1;
+	state->targetYaw = n + 2;
+}
+
+
+/* *****************************************************************************
+ * stateMatches_p: returns true if state is the one stateFor makes from its
+ * timestamp.
+ */
+static bool
+stateMatches_p (const flightState_t *state)
+{
+	flightState_t expected;
+
+	stateFor(&expected, state->timestamp);
+	return memcmp(state, &expected, sizeof(expected)) == 0;
+}
+
+
+/* *****************************************************************************
+ * testSequence: the sequence count starts at zero and advances by two on each
+ * publish, with the state published last.
+ */
+static void
+testSequence (void)
+{
+	stateLatch_t latch;
+	flightState_t state;
+	uint32_t n;
+
+	stateFor(&state, 0);
+	initStateLatch(&latch, &state);
+	CHECK_EQUAL(readState(&latch, &state), 0);
+	CHECK(stateMatches_p(&state));
+	CHECK_EQUAL(state.timestamp, 0);
+
+	for (n = 1; n <= 3; n++) {
+		stateFor(&state, n);
+		publishState(&latch, &state);
+	}
+	CHECK_EQUAL(readState(&latch, &state), 6);
+	CHECK(stateMatches_p(&state));
+	CHECK_EQUAL(state.timestamp, 3);
+}
+
+
+/* *****************************************************************************
+ * testReadMidPublish: a reader that preempts the writer between its halves
+ * (sequence odd, copy 0 part written) gets the previous state from copy 1,
+ * with the previous sequence count.
+ */
+static void
+testReadMidPublish (void)
+{
+	stateLatch_t latch;
+	flightState_t state;
+
+	stateFor(&state, 0);
+	initStateLatch(&latch, &state);
+	stateFor(&state, 1);
+	publishState(&latch, &state);
+
+	// The writer's first half of publishing state 2, cut short
+	latch.sequence++;
+	latch.copy[0].timestamp = 2;
+	latch.copy[0].altitude = 2;
+
+	CHECK_EQUAL(readState(&latch, &state), 2);
+	CHECK(stateMatches_p(&state));
+	CHECK_EQUAL(state.timestamp, 1);
+}
+
+
+/* *****************************************************************************
+ * readerThread: stands in for the controller ISR, reading the latch until
+ * stopped. Returns the number of torn, stale or out of order reads.
+ */
+static void *
+readerThread (void *arg)
+{
+	uintptr_t bad = 0;
+	uint32_t lastSequence = 0;
+	uint32_t sequence;
+	flightState_t state;
+
+	while (!g_stopReaders) {
+		sequence = readState(&g_sharedLatch, &state);
+		if (!stateMatches_p(&state) || (sequence & 1) || (sequence / 2 != state.timestamp)
+				|| (sequence < lastSequence)) {
+			bad++;
+		}
+		lastSequence = sequence;
+	}
+	return (void *)bad;
+}
+
+
+/* *****************************************************************************
+ * testReadWhilePublishing: every read taken during concurrent publishes must
+ * be one whole published state, with its own sequence count, and the counts
+ * seen by a reader never go backwards.
+ */
+static void
+testReadWhilePublishing (void)
+{
+	pthread_t readers[LATCH_READERS];
+	flightState_t state;
+	void *bad;
+	uint32_t n;
+	uint32_t i;
+
+	stateFor(&state, 0);
+	initStateLatch(&g_sharedLatch, &state);
+	g_stopReaders = 0;
+	for (i = 0; i < LATCH_READERS; i++) {
+		CHECK(pthread_create(&readers[i], NULL, readerThread, NULL) == 0);
+	}
+
+	for (n = 1; n <= LATCH_PUBLISHES; n++) {
+		stateFor(&state, n);
+		publishState(&g_sharedLatch, &state);
+	}
+
+	g_stopReaders = 1;
+	for (i = 0; i < LATCH_READERS; i++) {
+		pthread_join(readers[i], &bad);
+		CHECK_EQUAL((uintptr_t)bad, 0);
+	}
+	CHECK_EQUAL(readState(&g_sharedLatch, &state), 2 * LATCH_PUBLISHES);
+}
+
+
+int
+main (void)
+{
+	testSequence();
+	testReadMidPublish();
+	testReadWhilePublishing();
+	return testReport("testStateLatch");
+}
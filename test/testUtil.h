@@ -0,0 +1,72 @@
+#ifndef TESTUTIL_H_
+#define TESTUTIL_H_
+
+/* *****************************************************************************
+ * testUtil.h
+ *
+ * Minimal checks for the host unit tests. A failed check is reported with its
+ * location, and the test carries on; testReport prints a summary and returns
+ * the exit status for main.
+ *
+ * Hangwen Hu and Marc Katzef
+ * Last modified:  16.10.2026
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+static int g_testChecks = 0;
+static int g_testFailures = 0;
+
+/* *****************************************************************************
+ * CHECK: records a failure if cond is false.
+ */
+#define CHECK(cond) \
+	do { \
+		g_testChecks++; \
+		if (!(cond)) { \
+			g_testFailures++; \
+			printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+		} \
+	} while (0)
+
+/* *****************************************************************************
+ * CHECK_EQUAL: records a failure, with both values, if actual != expected.
+ */
+#define CHECK_EQUAL(actual, expected) \
+	do { \
+		long long actualValue = (long long)(actual); \
+		long long expectedValue = (long long)(expected); \
+		g_testChecks++; \
+		if (actualValue != expectedValue) { \
+			g_testFailures++; \
+			printf("%s:%d: check failed: %s == %s (%lld != %lld)\n", __FILE__, __LINE__, \
+					#actual, #expected, actualValue, expectedValue); \
+		} \
+	} while (0)
+
+/* *****************************************************************************
+ * testReport: prints the number of checks and failures of the test called
+ * name. Returns 0 if every check passed, otherwise 1.
+ */
+static inline int
+testReport (const char *name)
+{
+	printf("%s: %d checks, %d failed\n", name, g_testChecks, g_testFailures);
+	return g_testFailures ? 1 : 0;
+}
+
+/* *****************************************************************************
+ * testSeconds: returns a monotonic time in seconds, for the benchmarks.
+ */
+static inline double
+testSeconds (void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+#endif /* TESTUTIL_H_ */
@@ -0,0 +1,177 @@
+/* *****************************************************************************
+ * testYawQei.c
+ *
+ * Host tests for the yawmeter with YAW_BACKEND_QEI, against the fake QEI:
+ * set-up, calibration on the first index pulse, multi-turn position across
+ * counter wraps, velocity, phase errors and drift correction at the index.
+ *
+ * Hangwen Hu and Marc Katzef
+ * Last modified:  16.10.2026
+ */
+
+#include "testUtil.h"
+#include "fakeTiva.h"
+#include "yawmeter.h"
+
+#include <stdint.h>
+
+#define VELOCITY_CHUNK 50 // edges per velocity period, under half a turn
+
+static int32_t g_angle; // true position in counts, not wrapped
+
+/* *****************************************************************************
+ * rotate: turns the encoder by edges counts one at a time, with an index
+ * pulse at each pass of the reference. missed edges of the turn are not seen
+ * by the QEI. A velocity period ends every periodEdges edges (never if 0).
+ */
+static void
+rotate (int32_t edges, int32_t missed, uint32_t periodEdges)
+{
+	int32_t step = (edges > 0) ? 1 : -1;
+	uint32_t sincePeriod = 0;
+
+	while (edges != 0) {
+		g_angle += step;
+		if (missed > 0) {
+			missed--;
+		} else {
+			fakeQeiStep(step);
+		}
+		if (g_angle % INTERRUPTS_PER_REV == 0) {
+			fakeQeiIndex();
+		}
+		if (periodEdges && (++sincePeriod == periodEdges)) {
+			fakeQeiVelocityPeriod();
+			sincePeriod = 0;
+		}
+		edges -= step;
+	}
+}
+
+
+/* *****************************************************************************
+ * testSetup: every edge is counted in one revolution, the index resets the
+ * position and is active low, and the velocity is captured
+ * YAW_QEI_VELOCITY_RATE times per second.
+ */
+static void
+testSetup (void)
+{
+	uint32_t control = HWREG(QEI1_BASE + QEI_O_CTL);
+
+	CHECK(g_fakeQei.enabled);
+	CHECK_EQUAL(g_fakeQei.maxPosition, INTERRUPTS_PER_REV - 1);
+	CHECK(control & QEI_CTL_RESMODE);
+	CHECK(control & QEI_CTL_INVI);
+	CHECK_EQUAL(g_fakeQei.velocityPeriod, FAKE_CLOCK_HZ / YAW_QEI_VELOCITY_RATE);
+	CHECK_EQUAL(g_fakeQei.intEnabled, QEI_INTINDEX | QEI_INTERROR | QEI_INTTIMER);
+}
+
+
+/* *****************************************************************************
+ * testCalibration: the first index pulse zeroes the position and stops the
+ * hardware reset, so later passes are left to the drift correction.
+ */
+static void
+testCalibration (void)
+{
+	g_angle = -37;
+	rotate(20, 0, 0);
+	CHECK(!yawCalibrated_p());
+	rotate(17, 0, 0);
+	CHECK(yawCalibrated_p());
+	CHECK_EQUAL(getYawPosition(), 0);
+	CHECK(!(HWREG(QEI1_BASE + QEI_O_CTL) & QEI_CTL_RESMODE));
+}
+
+
+/* *****************************************************************************
+ * testMultiTurn: the position keeps counting over several turns each way,
+ * including a wrap of the counter since the last velocity period.
+ */
+static void
+testMultiTurn (void)
+{
+	rotate(3 * INTERRUPTS_PER_REV + 17, 0, VELOCITY_CHUNK);
+	CHECK_EQUAL(getYawPosition(), 3 * INTERRUPTS_PER_REV + 17);
+	CHECK_EQUAL(getYawCount(), 17);
+	CHECK_EQUAL(getCurrentYaw(), 17 * 360 / INTERRUPTS_PER_REV);
+
+	rotate(-50, 0, 0);
+	CHECK_EQUAL(getYawPosition(), 3 * INTERRUPTS_PER_REV - 33);
+	CHECK_EQUAL(getYawCount(), INTERRUPTS_PER_REV - 33);
+
+	rotate(-2 * INTERRUPTS_PER_REV, 0, VELOCITY_CHUNK);
+	CHECK_EQUAL(getYawPosition(), g_angle);
+}
+
+
+/* *****************************************************************************
+ * testVelocity: the rate is the edges of the last velocity period, signed by
+ * direction.
+ */
+static void
+testVelocity (void)
+{
+	fakeQeiVelocityPeriod(); // Start a period
+	rotate(25, 0, 25);
+	CHECK_EQUAL(getYawRate(), 25 * YAW_QEI_VELOCITY_RATE * CENTIDEGREES_PER_REV / INTERRUPTS_PER_REV);
+	rotate(-10, 0, 10);
+	CHECK_EQUAL(getYawRate(), -10 * YAW_QEI_VELOCITY_RATE * CENTIDEGREES_PER_REV / INTERRUPTS_PER_REV);
+}
+
+
+/* *****************************************************************************
+ * testPhaseErrors: each phase error interrupt is counted.
+ */
+static void
+testPhaseErrors (void)
+{
+	fakeQeiPhaseError();
+	fakeQeiPhaseError();
+	CHECK_EQUAL(getYawIllegalTransitions(), 2);
+}
+
+
+/* *****************************************************************************
+ * testDriftCorrection: edges missed by the QEI are corrected at the next index
+ * pulse, unless the reference interrupt is disabled.
+ */
+static void
+testDriftCorrection (void)
+{
+	int32_t start;
+
+	// Align with the reference, and let the clockwise entry count be learned
+	rotate(INTERRUPTS_PER_REV - ((g_angle % INTERRUPTS_PER_REV) + INTERRUPTS_PER_REV) % INTERRUPTS_PER_REV,
+			0, VELOCITY_CHUNK);
+	rotate(INTERRUPTS_PER_REV, 0, VELOCITY_CHUNK);
+	CHECK_EQUAL(getYawPosition(), g_angle);
+	start = g_angle;
+
+	disableYawRefInt();
+	rotate(INTERRUPTS_PER_REV, 3, VELOCITY_CHUNK);
+	CHECK_EQUAL(getYawPosition(), g_angle - 3);
+
+	enableYawRefInt();
+	rotate(INTERRUPTS_PER_REV, 0, VELOCITY_CHUNK);
+	CHECK_EQUAL(getYawPosition(), g_angle);
+	CHECK_EQUAL(getYawCount(), 0);
+	CHECK(getYawSlip() > 0);
+	CHECK_EQUAL(g_angle - start, 2 * INTERRUPTS_PER_REV);
+}
+
+
+int
+main (void)
+{
+	initYawmeter();
+
+	testSetup();
+	testCalibration();
+	testMultiTurn();
+	testVelocity();
+	testPhaseErrors();
+	testDriftCorrection();
+	return testReport("testYawQei");
+}
@@ -0,0 +1,245 @@
+/* *****************************************************************************
+ * testYawRate.c
+ *
+ * Host tests for the edge-timestamped yaw rate of YAW_BACKEND_GPIO, against
+ * the fake GPIO and timers: the period method at low speed, the window method
+ * at high speed, decay to zero when rotation stops, and readings across the
+ * wrap of the edge timer.
+ *
+ * Hangwen Hu and Marc Katzef
+ * Last modified:  16.10.2026
+ */
+
+#include "testUtil.h"
+#include "fakeTiva.h"
+#include "yawmeter.h"
+
+#include <stdint.h>
+#include <math.h>
+
+#define CALL_TICKS (FAKE_CLOCK_HZ / 100) // getYawRate called every 10 ms
+#define TIMER_WRAP_TICKS 4294967296.0
+#define RATE_TOLERANCE 0.01
+
+static const uint32_t g_quadStates[4] = { 0, 1, 3, 2 }; // clockwise order
+
+static uint32_t g_quadIndex;
+static double g_now; // simulated time in ticks
+static uint64_t g_timerTicks; // ticks already passed to the fake timer
+static double g_nextEdge; // time of the next edge, in the past once stopped
+
+/* *****************************************************************************
+ * advanceTo: lets the simulated time reach time (in ticks).
+ */
+static void
+advanceTo (double time)
+{
+	uint64_t ticks = (uint64_t)time;
+
+	g_now = time;
+	while (g_timerTicks < ticks) {
+		uint64_t step = ticks - g_timerTicks;
+
+		step = (step > 0x80000000u) ? 0x80000000u : step;
+		fakeTimerAdvance(YAW_TIMER_BASE, (uint32_t)step);
+		g_timerTicks += step;
+	}
+}
+
+
+/* *****************************************************************************
+ * stepEncoder: moves the encoder one edge clockwise (step 1) or anticlockwise
+ * (step -1), changing one channel of PB0 (A) and PB1 (B).
+ */
+static void
+stepEncoder (int32_t step)
+{
+	uint32_t state;
+
+	g_quadIndex = (g_quadIndex + step) & 3;
+	state = g_quadStates[g_quadIndex];
+	fakeGpioSet(YAW_BASE_A, YAW_PIN_A, (state >> 1) & 1);
+	fakeGpioSet(YAW_BASE_B, YAW_PIN_B, state & 1);
+}
+
+
+/* *****************************************************************************
+ * trueRate: returns the rate in centidegrees per second of edgesPerSecond.
+ */
+static double
+trueRate (double edgesPerSecond)
+{
+	return edgesPerSecond * CENTIDEGREES_PER_REV / INTERRUPTS_PER_REV;
+}
+
+
+/* *****************************************************************************
+ * rateClose_p: returns true if rate is within RATE_TOLERANCE of expected.
+ */
+static bool
+rateClose_p (int32_t rate, double expected)
+{
+	return fabs(rate - expected) <= RATE_TOLERANCE * fabs(expected);
+}
+
+
+/* *****************************************************************************
+ * spin: rotates at edgesPerSecond (signed, clockwise positive; 0 stops) for
+ * calls calls of getYawRate, one every CALL_TICKS. Counts the readings after
+ * the first settle calls that are not within RATE_TOLERANCE of the true rate.
+ * An edge already due keeps its time. Returns the last reading.
+ */
+static int32_t
+spin (double edgesPerSecond, uint32_t calls, uint32_t settle, uint32_t *misses)
+{
+	double interval = (edgesPerSecond != 0) ? FAKE_CLOCK_HZ / fabs(edgesPerSecond) : 0;
+	int32_t step = (edgesPerSecond > 0) ? 1 : -1;
+	int32_t rate = 0;
+	uint32_t i;
+
+	if ((interval != 0) && (g_nextEdge <= g_now)) {
+		g_nextEdge = g_now + interval; // Starting, rather than changing speed
+	}
+	for (i = 0; i < calls; i++) {
+		double callTime = g_now + CALL_TICKS;
+
+		while ((interval != 0) && (g_nextEdge <= callTime)) {
+			advanceTo(g_nextEdge);
+			stepEncoder(step);
+			g_nextEdge += interval;
+		}
+		advanceTo(callTime);
+		rate = getYawRate();
+		if ((i >= settle) && !rateClose_p(rate, trueRate(edgesPerSecond)) && misses) {
+			(*misses)++;
+		}
+	}
+	return rate;
+}
+
+
+/* *****************************************************************************
+ * testLowSpeed: under YAW_RATE_WINDOW_EDGES edges per call, the rate comes from
+ * the period of the latest edges, and holds between edges.
+ */
+static void
+testLowSpeed (void)
+{
+	uint32_t misses = 0;
+
+	spin(20, 100, 30, &misses);		// an edge every 5 calls
+	spin(100, 100, 10, &misses);	// an edge every call
+	spin(-300, 100, 10, &misses);
+	spin(-750, 100, 10, &misses);	// 7.5 edges per call
+	CHECK_EQUAL(misses, 0);
+}
+
+
+/* *****************************************************************************
+ * testHighSpeed: with YAW_RATE_WINDOW_EDGES or more edges per call, the rate
+ * counts the edges over the window, timed from edge to edge.
+ */
+static void
+testHighSpeed (void)
+{
+	uint32_t misses = 0;
+
+	spin(1000, 100, 10, &misses);
+	spin(5000, 100, 10, &misses);
+	spin(-12345, 100, 10, &misses);
+	spin(40000, 100, 10, &misses);
+	CHECK_EQUAL(misses, 0);
+}
+
+
+/* *****************************************************************************
+ * testStop: once the edges stop, the rate decays towards zero (never above the
+ * last rate) and reads zero from YAW_RATE_TIMEOUT_MS after the last edge.
+ */
+static void
+testStop (void)
+{
+	uint32_t timeoutCalls = YAW_RATE_TIMEOUT_MS / 10;
+	int32_t previous = spin(100, 50, 0, 0);
+	int32_t rate;
+	uint32_t i;
+	bool decays = true;
+
+	for (i = 0; i <= timeoutCalls; i++) {
+		rate = spin(0, 1, 0, 0);
+		decays = decays && (rate <= previous) && (rate >= 0);
+		previous = rate;
+	}
+	CHECK(decays);
+	CHECK_EQUAL(rate, 0);
+
+	spin(-5000, 50, 0, 0);
+	for (i = 0; i <= timeoutCalls; i++) {
+		rate = spin(0, 1, 0, 0);
+	}
+	CHECK_EQUAL(rate, 0);
+}
+
+
+/* *****************************************************************************
+ * testTimerWrap: the readings stay right while the edge timer wraps from 0 to
+ * its load value, at both speeds.
+ */
+static void
+testTimerWrap (void)
+{
+	uint32_t misses = 0;
+	uint32_t beforeWrap;
+
+	// Idle (with the calls continuing) until half a second before the wrap
+	spin(0, (FAKE_TIMER(YAW_TIMER_BASE)->value - FAKE_CLOCK_HZ / 2) / CALL_TICKS, 0, 0);
+	beforeWrap = FAKE_TIMER(YAW_TIMER_BASE)->value;
+	spin(200, 100, 30, &misses);
+	CHECK(FAKE_TIMER(YAW_TIMER_BASE)->value > beforeWrap);
+
+	spin(0, (uint32_t)(TIMER_WRAP_TICKS / CALL_TICKS) - 100, 0, 0);
+	spin(-3000, 100, 10, &misses);
+	CHECK_EQUAL(misses, 0);
+}
+
+
+/* *****************************************************************************
+ * testLongIdle: after a stop of about a whole timer period, the edges before
+ * the stop look recent in the wrapped timestamps. The edges after it must be
+ * timed on their own, at either speed.
+ */
+static void
+testLongIdle (void)
+{
+	int32_t rate;
+	int32_t highest = 0;
+	uint32_t i;
+
+	spin(100, 50, 0, 0);
+	spin(0, (uint32_t)(TIMER_WRAP_TICKS / CALL_TICKS), 0, 0);
+	for (i = 0; i < 100; i++) {
+		rate = spin(25, 1, 0, 0);
+		highest = (rate > highest) ? rate : highest;
+	}
+	CHECK(highest <= trueRate(25) * (1 + RATE_TOLERANCE));
+	CHECK(rateClose_p(rate, trueRate(25)));
+
+	// Straight to high speed, counted over the window from the first edge
+	spin(0, (uint32_t)(TIMER_WRAP_TICKS / CALL_TICKS), 0, 0);
+	CHECK(rateClose_p(spin(-6000, 1, 0, 0), trueRate(-6000)));
+}
+
+
+int
+main (void)
+{
+	fakeGpioSet(YAW_BASE_REF, YAW_PIN_REF, true); // Reference inactive (high)
+	initYawmeter();
+
+	testLowSpeed();
+	testHighSpeed();
+	testStop();
+	testTimerWrap();
+	testLongIdle();
+	return testReport("testYawRate");
+}
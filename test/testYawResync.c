@@ -0,0 +1,283 @@
+/* *****************************************************************************
+ * testYawResync.c
+ *
+ * Host tests for the yaw drift correction: yawResync on its own (learning,
+ * deadband, bounded corrections, slip statistic, and long runs with injected
+ * edge loss), then through the YAW_BACKEND_GPIO reference interrupt against
+ * the fake GPIO.
+ *
+ * Hangwen Hu and Marc Katzef
+ * Last modified:  16.10.2026
+ */
+
+#include "testUtil.h"
+#include "fakeTiva.h"
+#include "yawmeter.h"
+#include "yawResync.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#define REF_WIDTH 8 // counts over which the reference signal is active
+#define LOSS_REVOLUTIONS 2000
+#define LOSS_PER_MILLE 2 // edges lost per thousand
+#define REVERSE_EDGES (INTERRUPTS_PER_REV * 37) // edges between reversals
+
+static const uint32_t g_quadStates[4] = { 0, 1, 3, 2 }; // clockwise order
+
+static int32_t g_angle; // true position in counts, not wrapped
+static uint32_t g_quadIndex;
+
+/* *****************************************************************************
+ * wrapCount: returns count wrapped to [0, INTERRUPTS_PER_REV).
+ */
+static int32_t
+wrapCount (int32_t count)
+{
+	count %= INTERRUPTS_PER_REV;
+	return (count < 0) ? count + INTERRUPTS_PER_REV : count;
+}
+
+
+/* *****************************************************************************
+ * refActive_p: returns true if the reference signal is active at angle.
+ */
+static bool
+refActive_p (int32_t angle)
+{
+	return wrapCount(angle) < REF_WIDTH;
+}
+
+
+/* *****************************************************************************
+ * testLearning: the first pass of each edge in each direction is learned, not
+ * corrected, and later passes are measured against it.
+ */
+static void
+testLearning (void)
+{
+	yawResync_t resync;
+
+	initYawResync(&resync, 4, 1);
+	setYawResyncReference(&resync, YAW_REF_ENTER, DIRECTION_CW, 0);
+	CHECK_EQUAL(yawResyncUpdate(&resync, YAW_REF_LEAVE, DIRECTION_CW, REF_WIDTH), 0);
+	CHECK_EQUAL(yawResyncUpdate(&resync, YAW_REF_LEAVE, DIRECTION_ANTI_CW, REF_WIDTH - 1), 0);
+	CHECK_EQUAL(yawResyncUpdate(&resync, YAW_REF_ENTER, DIRECTION_ANTI_CW, 30), 0);
+	CHECK_EQUAL(resync.revolutions, 0);
+
+	CHECK_EQUAL(yawResyncUpdate(&resync, YAW_REF_ENTER, DIRECTION_ANTI_CW, 33), 3);
+	CHECK_EQUAL(yawResyncUpdate(&resync, YAW_REF_LEAVE, DIRECTION_CW, REF_WIDTH - 2), -2);
+	CHECK_EQUAL(resync.revolutions, 1);
+}
+
+
+/* *****************************************************************************
+ * testBounds: errors within the deadband are left alone, larger ones are
+ * corrected by at most the maximum, measured the short way round.
+ */
+static void
+testBounds (void)
+{
+	yawResync_t resync;
+
+	initYawResync(&resync, 4, 1);
+	setYawResyncReference(&resync, YAW_REF_ENTER, DIRECTION_CW, 0);
+	CHECK_EQUAL(yawResyncUpdate(&resync, YAW_REF_ENTER, DIRECTION_CW, 1), 0);
+	CHECK_EQUAL(yawResyncUpdate(&resync, YAW_REF_ENTER, DIRECTION_CW, INTERRUPTS_PER_REV - 1), 0);
+	CHECK_EQUAL(yawResyncUpdate(&resync, YAW_REF_ENTER, DIRECTION_CW, 3), 3);
+	CHECK_EQUAL(yawResyncUpdate(&resync, YAW_REF_ENTER, DIRECTION_CW, INTERRUPTS_PER_REV - 3), -3);
+	CHECK_EQUAL(yawResyncUpdate(&resync, YAW_REF_ENTER, DIRECTION_CW, 100), 4);
+	CHECK_EQUAL(resync.lastError, 100);
+	CHECK_EQUAL(yawResyncUpdate(&resync, YAW_REF_ENTER, DIRECTION_CW, INTERRUPTS_PER_REV / 2 + 10), -4);
+
+	// 3 + 3 + 4 + 4 counts corrected over 6 revolutions
+	CHECK_EQUAL(getYawResyncSlip(&resync), 1400 / 6);
+}
+
+
+/* *****************************************************************************
+ * simulateEdgeLoss: turns the encoder for LOSS_REVOLUTIONS revolutions,
+ * reversing every REVERSE_EDGES edges, and loses LOSS_PER_MILLE of the edges.
+ * Corrects at each reference edge if resync is true. Returns the largest
+ * error after calibration, and sets *finalError and *slip.
+ */
+static int32_t
+simulateEdgeLoss (bool resync, int32_t *finalError, uint32_t *slip)
+{
+	yawResync_t state;
+	int32_t angle = -1;
+	int32_t count = 0;
+	int32_t direction = -1;
+	int32_t maxError = 0;
+	int32_t error;
+	bool calibrated = false;
+	bool wasActive;
+	uint32_t i;
+
+	initYawResync(&state, YAW_RESYNC_MAX_CORRECTION, YAW_RESYNC_DEADBAND);
+	srand(22);
+	for (i = 0; i < (uint32_t)LOSS_REVOLUTIONS * INTERRUPTS_PER_REV; i++) {
+		if (i % REVERSE_EDGES == 0) {
+			direction = -direction;
+		}
+		wasActive = refActive_p(angle);
+		angle += direction;
+		if (rand() % 1000 >= LOSS_PER_MILLE) {
+			count += direction;
+		}
+
+		if (refActive_p(angle) != wasActive) {
+			yawRefEdge_t edge = wasActive ? YAW_REF_LEAVE : YAW_REF_ENTER;
+			yawDirection_t turn = (direction > 0) ? DIRECTION_CW : DIRECTION_ANTI_CW;
+
+			if (!calibrated) {
+				count = angle;
+				setYawResyncReference(&state, edge, turn, wrapCount(count));
+				calibrated = true;
+			} else if (resync) {
+				count -= yawResyncUpdate(&state, edge, turn, wrapCount(count));
+			}
+		}
+		if (calibrated) {
+			error = abs(yawDifference(wrapCount(angle), wrapCount(count)));
+			maxError = (error > maxError) ? error : maxError;
+		}
+	}
+	*finalError = abs(yawDifference(wrapCount(angle), wrapCount(count)));
+	*slip = getYawResyncSlip(&state);
+	return maxError;
+}
+
+
+/* *****************************************************************************
+ * testEdgeLoss: with edges lost at random, the error keeps growing without
+ * correction, and stays within a few counts with it. The slip statistic shows
+ * about the edges lost per revolution.
+ */
+static void
+testEdgeLoss (void)
+{
+	int32_t finalError;
+	int32_t maxError;
+	uint32_t slip;
+
+	maxError = simulateEdgeLoss(false, &finalError, &slip);
+	CHECK(maxError > 20);
+	CHECK_EQUAL(slip, 0);
+
+	maxError = simulateEdgeLoss(true, &finalError, &slip);
+	CHECK(maxError <= 2 * YAW_RESYNC_MAX_CORRECTION);
+	CHECK(finalError <= YAW_RESYNC_DEADBAND + 1);
+	CHECK(slip > INTERRUPTS_PER_REV * LOSS_PER_MILLE * 100 / 1000 / 2);
+	CHECK(slip < INTERRUPTS_PER_REV * LOSS_PER_MILLE * 100 / 1000 * 2);
+}
+
+
+/* *****************************************************************************
+ * stepEncoder: moves the encoder one edge clockwise (step 1) or anticlockwise
+ * (step -1) on PB0/PB1, and the reference signal on PC4 with it.
+ */
+static void
+stepEncoder (int32_t step)
+{
+	uint32_t state;
+
+	g_angle += step;
+	g_quadIndex = (g_quadIndex + step) & 3;
+	state = g_quadStates[g_quadIndex];
+	fakeGpioSet(YAW_BASE_A, YAW_PIN_A, (state >> 1) & 1);
+	fakeGpioSet(YAW_BASE_B, YAW_PIN_B, state & 1);
+	fakeGpioSet(YAW_BASE_REF, YAW_PIN_REF, !refActive_p(g_angle)); // Active low
+}
+
+
+/* *****************************************************************************
+ * rotate: turns the encoder by edges counts.
+ */
+static void
+rotate (int32_t edges)
+{
+	int32_t step = (edges > 0) ? 1 : -1;
+
+	for (; edges != 0; edges -= step) {
+		stepEncoder(step);
+	}
+}
+
+
+/* *****************************************************************************
+ * missEdges: turns the encoder two edges clockwise while interrupts are held
+ * back, so the decoder sees both channels change at once and counts neither.
+ */
+static void
+missEdges (void)
+{
+	IntMasterDisable();
+	stepEncoder(1);
+	stepEncoder(1);
+	IntMasterEnable();
+}
+
+
+/* *****************************************************************************
+ * testGpioCalibration: the first reference edge zeroes the position, and the
+ * level set up before initYawmeter is not taken for an edge.
+ */
+static void
+testGpioCalibration (void)
+{
+	rotate(INTERRUPTS_PER_REV / 4);
+	CHECK(!yawCalibrated_p());
+	rotate(-g_angle);
+	CHECK(yawCalibrated_p());
+	CHECK_EQUAL(getYawPosition(), 0);
+}
+
+
+/* *****************************************************************************
+ * testGpioDriftCorrection: edges missed while the reference interrupt is
+ * disabled are corrected at the passes after it is enabled again. Reference
+ * edges seen while it was disabled are not acted on when it is enabled.
+ */
+static void
+testGpioDriftCorrection (void)
+{
+	int32_t i;
+
+	// Let the clockwise leave count be learned
+	rotate(INTERRUPTS_PER_REV);
+	CHECK_EQUAL(getYawPosition(), g_angle);
+
+	disableYawRefInt();
+	rotate(INTERRUPTS_PER_REV / 2);
+	missEdges();
+	missEdges();
+	rotate(INTERRUPTS_PER_REV / 2 + 20);
+	CHECK_EQUAL(getYawPosition(), g_angle - 4);
+	CHECK_EQUAL(getYawIllegalTransitions(), 2);
+
+	enableYawRefInt();
+	CHECK_EQUAL(getYawPosition(), g_angle - 4);
+
+	for (i = 0; i < 2; i++) {
+		rotate(INTERRUPTS_PER_REV);
+	}
+	CHECK_EQUAL(getYawPosition(), g_angle);
+	CHECK(getYawSlip() > 0);
+}
+
+
+int
+main (void)
+{
+	testLearning();
+	testBounds();
+	testEdgeLoss();
+
+	g_angle = -INTERRUPTS_PER_REV / 2;
+	fakeGpioSet(YAW_BASE_REF, YAW_PIN_REF, true); // Reference inactive
+	initYawmeter();
+	testGpioCalibration();
+	testGpioDriftCorrection();
+	return testReport("testYawResync");
+}
@@ -0,0 +1,162 @@
+/* *****************************************************************************
+ * yawQei.c
+ *
+ * Hardware access for the QEI yawmeter backend, using the TM4C123 quadrature
+ * encoder interface.
+ *
+ * Hangwen Hu and Marc Katzef
+ * Last modified:  16.10.2026
+ */
+
+#include "yawQei.h"
+#include "yawmeter.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "inc/hw_memmap.h"
+#include "inc/hw_types.h"
+#include "inc/hw_ints.h"
+#include "inc/hw_qei.h"
+#include "driverlib/gpio.h"
+#include "driverlib/qei.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/pin_map.h"
+
+#if YAW_BACKEND == YAW_BACKEND_QEI
+
+/* *****************************************************************************
+ * initYawQei: configures the encoder pins and QEI module to count every edge
+ * of both channels in [0, countsPerRev), resetting to 0 on the index signal,
+ * and to capture velocity velocityRate times per second. intHandler is called
+ * on index, phase error and velocity timer events.
+ */
+void
+initYawQei (uint32_t countsPerRev, uint32_t velocityRate, void (*intHandler)(void))
+{
+	SysCtlPeripheralEnable(YAW_PERIPH_QEI);
+	SysCtlPeripheralEnable(YAW_PERIPH_REF);
+
+	GPIOPinConfigure(YAW_PINMUX_A);
+	GPIOPinConfigure(YAW_PINMUX_B);
+	GPIOPinConfigure(YAW_PINMUX_REF);
+	GPIOPinTypeQEI(YAW_BASE_REF, YAW_PIN_A | YAW_PIN_B | YAW_PIN_REF);
+	GPIOPadConfigSet(YAW_BASE_REF, YAW_PIN_A | YAW_PIN_B, GPIO_STRENGTH_2MA,
+			GPIO_PIN_TYPE_STD_WPD);
+	GPIOPadConfigSet(YAW_BASE_REF, YAW_PIN_REF, GPIO_STRENGTH_2MA,
+			GPIO_PIN_TYPE_STD_WPU);
+
+	QEIDisable(YAW_QEI_BASE);
+	QEIConfigure(YAW_QEI_BASE, QEI_CONFIG_CAPTURE_A_B | QEI_CONFIG_RESET_IDX |
+			QEI_CONFIG_QUADRATURE | QEI_CONFIG_NO_SWAP, countsPerRev - 1);
+	if (YAW_REF_ACTIVE_LEVEL == 0) {
+		HWREG(YAW_QEI_BASE + QEI_O_CTL) |= QEI_CTL_INVI; // QEI expects an active high index
+	}
+	QEIPositionSet(YAW_QEI_BASE, 0);
+
+	QEIVelocityConfigure(YAW_QEI_BASE, QEI_VELDIV_1, SysCtlClockGet() / velocityRate);
+	QEIVelocityEnable(YAW_QEI_BASE);
+
+	QEIIntRegister(YAW_QEI_BASE, intHandler);
+	QEIIntClear(YAW_QEI_BASE, QEI_INTINDEX | QEI_INTERROR | QEI_INTTIMER);
+	QEIIntEnable(YAW_QEI_BASE, QEI_INTINDEX | QEI_INTERROR | QEI_INTTIMER);
+	QEIEnable(YAW_QEI_BASE);
+}
+
+
+/* *****************************************************************************
+ * getYawQeiPosition: returns the position count, in [0, countsPerRev).
+ */
+uint32_t
+getYawQeiPosition (void)
+{
+	return QEIPositionGet(YAW_QEI_BASE);
+}
+
+
+/* *****************************************************************************
+ * setYawQeiPosition: sets the position count.
+ */
+void
+setYawQeiPosition (uint32_t position)
+{
+	QEIPositionSet(YAW_QEI_BASE, position);
+}
+
+
+/* *****************************************************************************
+ * getYawQeiVelocity: returns the signed number of edges counted over the last
+ * velocity capture period (positive clockwise).
+ */
+int32_t
+getYawQeiVelocity (void)
+{
+	return QEIDirectionGet(YAW_QEI_BASE) * (int32_t)QEIVelocityGet(YAW_QEI_BASE);
+}
+
+
+/* *****************************************************************************
+ * getYawQeiDirection: returns the direction of the latest edge, 1 for
+ * clockwise or -1 for anticlockwise.
+ */
+int32_t
+getYawQeiDirection (void)
+{
+	return QEIDirectionGet(YAW_QEI_BASE);
+}
+
+
+/* *****************************************************************************
+ * setYawQeiIndexReset: enables or disables resetting the position on the index
+ * signal.
+ */
+void
+setYawQeiIndexReset (bool enable)
+{
+	if (enable) {
+		HWREG(YAW_QEI_BASE + QEI_O_CTL) |= QEI_CTL_RESMODE;
+	} else {
+		HWREG(YAW_QEI_BASE + QEI_O_CTL) &= ~QEI_CTL_RESMODE;
+	}
+}
+
+
+/* *****************************************************************************
+ * setYawQeiIndexInt: enables or disables the index event. A pulse seen while
+ * the event was disabled is discarded rather than reported on enabling.
+ */
+void
+setYawQeiIndexInt (bool enable)
+{
+	if (enable) {
+		QEIIntClear(YAW_QEI_BASE, QEI_INTINDEX);
+		QEIIntEnable(YAW_QEI_BASE, QEI_INTINDEX);
+	} else {
+		QEIIntDisable(YAW_QEI_BASE, QEI_INTINDEX);
+	}
+}
+
+
+/* *****************************************************************************
+ * clearYawQeiEvents: clears and returns the pending YAW_QEI_EVENT flags.
+ */
+uint32_t
+clearYawQeiEvents (void)
+{
+	uint32_t status = QEIIntStatus(YAW_QEI_BASE, true);
+	uint32_t events = 0;
+
+	QEIIntClear(YAW_QEI_BASE, status);
+	if (status & QEI_INTINDEX) {
+		events |= YAW_QEI_EVENT_INDEX;
+	}
+	if (status & QEI_INTERROR) {
+		events |= YAW_QEI_EVENT_ERROR;
+	}
+	if (status & QEI_INTTIMER) {
+		events |= YAW_QEI_EVENT_TIMER;
+	}
+	return events;
+}
+
+#endif
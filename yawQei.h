@@ -0,0 +1,84 @@
+#ifndef YAWQEI_H_
+#define YAWQEI_H_
+
+/* *****************************************************************************
+ * yawQei.h
+ *
+ * Hardware access for the QEI yawmeter backend (YAW_BACKEND_QEI), using the
+ * TM4C123 quadrature encoder interface to count edges, reset the position on
+ * the reference (index) signal and capture velocity without per-edge
+ * interrupts.
+ *
+ * The yawmeter only uses these functions, so a fake providing them can be
+ * linked instead to check position and velocity handling off-target.
+ *
+ * Hangwen Hu and Marc Katzef
+ * Last modified:  16.10.2026
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* *****************************************************************************
+ * Events returned by clearYawQeiEvents
+ */
+#define YAW_QEI_EVENT_INDEX 0x1 // reference (index) signal detected
+#define YAW_QEI_EVENT_ERROR 0x2 // both channels changed at once
+#define YAW_QEI_EVENT_TIMER 0x4 // velocity capture period ended
+
+/* *****************************************************************************
+ * initYawQei: configures the encoder pins and QEI module to count every edge
+ * of both channels in [0, countsPerRev), resetting to 0 on the index signal,
+ * and to capture velocity velocityRate times per second. intHandler is called
+ * on index, phase error and velocity timer events.
+ */
+void
+initYawQei (uint32_t countsPerRev, uint32_t velocityRate, void (*intHandler)(void));
+
+/* *****************************************************************************
+ * getYawQeiPosition: returns the position count, in [0, countsPerRev).
+ */
+uint32_t
+getYawQeiPosition (void);
+
+/* *****************************************************************************
+ * setYawQeiPosition: sets the position count.
+ */
+void
+setYawQeiPosition (uint32_t position);
+
+/* *****************************************************************************
+ * getYawQeiVelocity: returns the signed number of edges counted over the last
+ * velocity capture period (positive clockwise).
+ */
+int32_t
+getYawQeiVelocity (void);
+
+/* *****************************************************************************
+ * getYawQeiDirection: returns the direction of the latest edge, 1 for
+ * clockwise or -1 for anticlockwise.
+ */
+int32_t
+getYawQeiDirection (void);
+
+/* *****************************************************************************
+ * setYawQeiIndexReset: enables or disables resetting the position on the index
+ * signal.
+ */
+void
+setYawQeiIndexReset (bool enable);
+
+/* *****************************************************************************
+ * setYawQeiIndexInt: enables or disables the index event. A pulse seen while
+ * the event was disabled is discarded rather than reported on enabling.
+ */
+void
+setYawQeiIndexInt (bool enable);
+
+/* *****************************************************************************
+ * clearYawQeiEvents: clears and returns the pending YAW_QEI_EVENT flags.
+ */
+uint32_t
+clearYawQeiEvents (void);
+
+#endif /* YAWQEI_H_ */
@@ -0,0 +1,108 @@
+/* *****************************************************************************
+ * yawResync.c
+ *
+ * Correction of yaw count drift at each pass of the reference point.
+ *
+ * Hangwen Hu and Marc Katzef
+ * Last modified:  16.10.2026
+ */
+
+#include "yawResync.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+/* *****************************************************************************
+ * initYawResync: forgets all learned reference counts and clears the
+ * statistics. Errors of at most deadband counts are treated as jitter and left
+ * alone; larger errors are corrected by at most maxCorrection counts per pass.
+ */
+void
+initYawResync (yawResync_t *resync, int32_t maxCorrection, int32_t deadband)
+{
+	uint32_t edge;
+	uint32_t direction;
+
+	for (edge = 0; edge < NUM_YAW_REF_EDGES; edge++) {
+		for (direction = 0; direction < NUM_YAW_DIRECTIONS; direction++) {
+			resync->refCount[edge][direction] = 0;
+			resync->learned[edge][direction] = false;
+		}
+	}
+	resync->maxCorrection = maxCorrection;
+	resync->deadband = deadband;
+	resync->lastError = 0;
+	resync->revolutions = 0;
+	resync->slipCounts = 0;
+}
+
+
+/* *****************************************************************************
+ * setYawResyncReference: sets the count for the given reference edge and
+ * direction, e.g. to zero at calibration.
+ */
+void
+setYawResyncReference (yawResync_t *resync, yawRefEdge_t edge,
+		yawDirection_t direction, int32_t count)
+{
+	resync->refCount[edge][direction] = count;
+	resync->learned[edge][direction] = true;
+}
+
+
+/* *****************************************************************************
+ * yawResyncUpdate: called at each reference edge with the wrapped count at
+ * that edge. Returns the correction to subtract from the count, which is zero
+ * the first time an edge is seen in a direction (its count is learned instead).
+ */
+int32_t
+yawResyncUpdate (yawResync_t *resync, yawRefEdge_t edge,
+		yawDirection_t direction, int32_t count)
+{
+	int32_t error;
+	int32_t correction;
+
+	if (!resync->learned[edge][direction]) {
+		setYawResyncReference(resync, edge, direction, count);
+		return 0;
+	}
+
+	// Error within half a revolution either way
+	error = (count - resync->refCount[edge][direction]) % INTERRUPTS_PER_REV;
+	if (error > INTERRUPTS_PER_REV / 2) {
+		error -= INTERRUPTS_PER_REV;
+	} else if (error < -(INTERRUPTS_PER_REV / 2)) {
+		error += INTERRUPTS_PER_REV;
+	}
+	resync->lastError = error;
+	if (edge == YAW_REF_ENTER) {
+		resync->revolutions++;
+	}
+
+	if (abs(error) <= resync->deadband) {
+		return 0;
+	}
+	correction = error;
+	if (correction > resync->maxCorrection) {
+		correction = resync->maxCorrection;
+	} else if (correction < -resync->maxCorrection) {
+		correction = -resync->maxCorrection;
+	}
+	resync->slipCounts += abs(correction);
+	return correction;
+}
+
+
+/* *****************************************************************************
+ * getYawResyncSlip: returns the mean correction per revolution, in hundredths
+ * of a count.
+ */
+uint32_t
+getYawResyncSlip (const yawResync_t *resync)
+{
+	if (resync->revolutions == 0) {
+		return 0;
+	}
+	return (resync->slipCounts * 100) / resync->revolutions;
+}
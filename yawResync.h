@@ -0,0 +1,73 @@
+#ifndef YAWRESYNC_H_
+#define YAWRESYNC_H_
+
+/* *****************************************************************************
+ * yawResync.h
+ *
+ * Correction of yaw count drift at each pass of the reference point.
+ *
+ * The count at which each edge of the reference pulse is seen depends on the
+ * edge and the direction of rotation, so the count is learned for each
+ * combination on its first pass. On later passes the difference from the
+ * learned count is slip (missed or extra encoder edges), and a correction of
+ * at most a set number of counts is returned, so a glitch on the reference
+ * signal cannot move the yaw far. Uses no hardware, so it can be exercised
+ * off-target with simulated edges.
+ *
+ * Hangwen Hu and Marc Katzef
+ * Last modified:  16.10.2026
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "yawmeter.h"
+
+/* *****************************************************************************
+ * Constants
+ */
+typedef enum yawRefEdge {YAW_REF_ENTER = 0, YAW_REF_LEAVE, NUM_YAW_REF_EDGES} yawRefEdge_t;
+#define NUM_YAW_DIRECTIONS 2
+
+typedef struct {
+	int32_t refCount[NUM_YAW_REF_EDGES][NUM_YAW_DIRECTIONS]; // learned count at each edge
+	bool learned[NUM_YAW_REF_EDGES][NUM_YAW_DIRECTIONS];
+	int32_t maxCorrection;
+	int32_t deadband;
+	int32_t lastError;		// counts, at the latest pass
+	uint32_t revolutions;	// passes entering the reference with a learned count
+	uint32_t slipCounts;	// total of the corrections made
+} yawResync_t;
+
+/* *****************************************************************************
+ * initYawResync: forgets all learned reference counts and clears the
+ * statistics. Errors of at most deadband counts are treated as jitter and left
+ * alone; larger errors are corrected by at most maxCorrection counts per pass.
+ */
+void
+initYawResync (yawResync_t *resync, int32_t maxCorrection, int32_t deadband);
+
+/* *****************************************************************************
+ * setYawResyncReference: sets the count for the given reference edge and
+ * direction, e.g. to zero at calibration.
+ */
+void
+setYawResyncReference (yawResync_t *resync, yawRefEdge_t edge,
+		yawDirection_t direction, int32_t count);
+
+/* *****************************************************************************
+ * yawResyncUpdate: called at each reference edge with the wrapped count at
+ * that edge. Returns the correction to subtract from the count, which is zero
+ * the first time an edge is seen in a direction (its count is learned instead).
+ */
+int32_t
+yawResyncUpdate (yawResync_t *resync, yawRefEdge_t edge,
+		yawDirection_t direction, int32_t count);
+
+/* *****************************************************************************
+ * getYawResyncSlip: returns the mean correction per revolution, in hundredths
+ * of a count.
+ */
+uint32_t
+getYawResyncSlip (const yawResync_t *resync);
+
+#endif /* YAWRESYNC_H_ */
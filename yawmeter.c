@@ -9,6 +9,10 @@
  */
 
 #include "yawmeter.h"
+#include "quadDecoder.h"
+#include "yawQei.h"
+#include "yawResync.h"
+#include "motors.h"
 
 #include <stdint.h>
 #include <stdbool.h>
@@ -16,16 +20,61 @@
 #include "inc/hw_types.h"
 #include "inc/hw_ints.h"
 #include "driverlib/gpio.h"
+#include "driverlib/timer.h"
 #include "driverlib/sysctl.h"
 #include "driverlib/interrupt.h"
 #include "driverlib/pin_map.h"
 #include "driverlib/debug.h"
 
-static volatile bool g_stateA = false;
-static volatile bool g_stateB = false;
+/* *****************************************************************************
+ * Pin budget check: the motors are initialised after the yawmeter, so a shared
+ * pin would silently be taken over by the PWM.
+ */
+#define YAW_PIN_USED_P(base, pin) \
+	((((base) == YAW_BASE_A) && ((pin) & YAW_PIN_A)) || \
+	(((base) == YAW_BASE_B) && ((pin) & YAW_PIN_B)) || \
+	(((base) == YAW_BASE_REF) && ((pin) & YAW_PIN_REF)))
+
+#if YAW_PIN_USED_P(PWM_MAIN_GPIO_BASE, PWM_MAIN_GPIO_PIN) || \
+		YAW_PIN_USED_P(PWM_TAIL_GPIO_BASE, PWM_TAIL_GPIO_PIN)
+#error "A yaw input shares a pin with a motor PWM output"
+#endif
+
+#if YAW_BACKEND == YAW_BACKEND_QEI
+static volatile uint32_t g_yawPhaseErrors = 0;
+
+// Whole turns of the QEI position, unwrapped on each velocity timer event
+static volatile int32_t g_yawTurns = 0;
+static volatile uint32_t g_qeiLastCount = 0;
+static volatile uint32_t g_qeiSeq = 0; // odd while the turns are being updated
+#else
+static quadDecoder_t g_yawDecoder;
 static volatile int16_t g_pinChangeInterruptCount = 0;
 static volatile yawDirection_t g_currentDirection = DIRECTION_CW;
+
+// Edge timestamps (timer ticks, counting down) and the net edge count at each
+static volatile uint32_t g_edgeTime[YAW_EDGE_HISTORY];
+static volatile int32_t g_edgePosition[YAW_EDGE_HISTORY];
+static volatile uint32_t g_edgeCount = 0;	// edges recorded
+static volatile uint32_t g_edgeSeq = 0;		// odd while an edge is being recorded
+static volatile int32_t g_yawPosition = 0;	// net edge count from the reference, not wrapped
+
+// Count over window state, from the previous call of getYawRate
+static uint32_t g_rateWindowTime;
+static int32_t g_rateWindowPosition;
+static uint32_t g_yawTimerRate;
+
+// Age of the latest edge in timer ticks, accumulated by getYawRate and
+// saturating past the timeout, so it does not wrap with the timer
+static uint32_t g_rateCallTime;
+static uint32_t g_edgeAge;
+static uint32_t g_edgeAgeCount; // g_edgeCount when g_edgeAge was last reset
+static uint32_t g_edgeStartCount; // g_edgeCount when rotation last started from rest
+
+static void zeroYawPosition (void);
+#endif
 static volatile bool g_yawCalibrated = false;
+static yawResync_t g_yawResync;
 
 /* *****************************************************************************
  * yawCalibrated_p: returns true if the yaw reference signal has been detected,
@@ -39,61 +88,253 @@ yawCalibrated_p (void)
 
 
 /* *****************************************************************************
- * yawDifference: returns the smallest (in magnitude) angle from between the
- * two given bearings. Measured from current to reference. Result will fall in
- * [-180, 180].
+ * yawRefActive_p: returns true if the yaw reference signal is active.
+ */
+static bool
+yawRefActive_p (void)
+{
+	return (GPIOPinRead(YAW_BASE_REF, YAW_PIN_REF) & YAW_PIN_REF) ==
+			(YAW_REF_ACTIVE_LEVEL ? YAW_PIN_REF : 0);
+}
+
+
+/* *****************************************************************************
+ * restoreYawCalibration: for a warm start where the helicopter is known to have
+ * landed at the reference point. If the reference signal is currently active,
+ * this confirms it: the yaw is zeroed and marked calibrated, and true is
+ * returned. Otherwise the yaw must be calibrated by finding the reference.
+ */
+bool
+restoreYawCalibration (void)
+{
+	bool refActive = yawRefActive_p();
+
+	if (refActive) {
+		// Counts at the reference edges are learned on the next passes
+		initYawResync(&g_yawResync, YAW_RESYNC_MAX_CORRECTION, YAW_RESYNC_DEADBAND);
+#if YAW_BACKEND == YAW_BACKEND_QEI
+		setYawQeiIndexReset(false);
+		setYawQeiPosition(0);
+		g_qeiLastCount = 0;
+		g_yawTurns = 0;
+#else
+		zeroYawPosition();
+#endif
+		g_yawCalibrated = true;
+	}
+	return refActive;
+}
+
+
+/* *****************************************************************************
+ * yawDifference: returns the smallest (in magnitude) difference between the
+ * two given positions, in encoder counts. Measured from current to reference.
+ * Positions may be wrapped or multi-turn. Result will fall in
+ * [-INTERRUPTS_PER_REV / 2, INTERRUPTS_PER_REV / 2].
  */
 int32_t
-yawDifference(uint16_t reference, uint16_t current)
+yawDifference (int32_t reference, int32_t current)
 {
-	int32_t yawError;
-	yawError = ((int32_t)reference) - current;
-	if (yawError < -180) {
-		yawError += 360;
-	} else if (yawError > 180) {
-		yawError -= 360;
+	int32_t yawError = reference - current;
+
+	// Reduce multi-turn differences to within a revolution
+	while (yawError > INTERRUPTS_PER_REV / 2) {
+		yawError -= INTERRUPTS_PER_REV;
+	}
+	while (yawError < -INTERRUPTS_PER_REV / 2) {
+		yawError += INTERRUPTS_PER_REV;
 	}
 	return yawError;
 }
 
 
+#if YAW_BACKEND == YAW_BACKEND_QEI
 /* *****************************************************************************
- * pinChangeIntHandler: carries out quadrature decoding using the two input
- * signals A and B. Increments g_pinChangeInterruptCount when clockwise movement
- * is read, decrements it for anticlockwise.
+ * turnsSinceCount: returns the change in whole turns from a QEI position of
+ * last to one of current, assuming less than half a turn between them.
  */
-void
-pinChangeIntHandler (void)
+static int32_t
+turnsSinceCount (uint32_t last, uint32_t current)
 {
-    GPIOIntClear (GPIO_PORTB_BASE, YAW_PIN_A);
-    GPIOIntClear (GPIO_PORTB_BASE, YAW_PIN_B);
+	int32_t change = (int32_t)current - (int32_t)last;
 
-    bool newStateA = (GPIOPinRead(YAW_BASE_A, YAW_PIN_A) & YAW_PIN_A) == YAW_PIN_A;
-    bool newStateB = (GPIOPinRead(YAW_BASE_B, YAW_PIN_B) & YAW_PIN_B) == YAW_PIN_B;
+	if (change < -(INTERRUPTS_PER_REV / 2)) {
+		return 1;
+	} else if (change > INTERRUPTS_PER_REV / 2) {
+		return -1;
+	}
+	return 0;
+}
 
-	int16_t pinChangeInterruptCount = g_pinChangeInterruptCount;
-	yawDirection_t direction = DIRECTION_CW;
 
-	if (newStateA != g_stateA) {
-		if (newStateA == newStateB) {
-			direction = DIRECTION_CW;
-		} else {
-			direction = DIRECTION_ANTI_CW;
-		}
+/* *****************************************************************************
+ * unwrapYawQei: counts whole turns as the QEI position wraps. Called at the
+ * velocity capture rate, which must see less than half a turn per period.
+ */
+static void
+unwrapYawQei (void)
+{
+	uint32_t count = getYawQeiPosition();
+
+	g_qeiSeq++;
+	g_yawTurns += turnsSinceCount(g_qeiLastCount, count);
+	g_qeiLastCount = count;
+	g_qeiSeq++;
+}
+
+
+/* *****************************************************************************
+ * shiftYawQeiPosition: adds shift to the QEI position, carrying any wrap into
+ * the whole turns.
+ */
+static void
+shiftYawQeiPosition (int32_t shift)
+{
+	int32_t count;
+
+	g_qeiSeq++;
+	count = (int32_t)getYawQeiPosition() + shift;
+	if (count >= INTERRUPTS_PER_REV) {
+		count -= INTERRUPTS_PER_REV;
+		g_yawTurns++;
+	} else if (count < 0) {
+		count += INTERRUPTS_PER_REV;
+		g_yawTurns--;
+	}
+	setYawQeiPosition(count);
+	g_qeiLastCount = count;
+	g_qeiSeq++;
+}
+
 
-	} else if (newStateB != g_stateB) {
-		if (newStateA != newStateB) {
-			direction = DIRECTION_CW;
+/* *****************************************************************************
+ * yawQeiIntHandler: called by the QEI on an index (reference) pulse, on phase
+ * errors, and at the end of each velocity capture period. The first index
+ * pulse has reset the position to zero in hardware, calibrating the yaw. Later
+ * pulses correct any drift through g_yawResync instead.
+ */
+void
+yawQeiIntHandler (void)
+{
+	uint32_t events = clearYawQeiEvents();
+	yawDirection_t direction;
+	int32_t correction;
+
+	if (events & YAW_QEI_EVENT_INDEX) {
+		direction = (getYawQeiDirection() > 0) ? DIRECTION_CW : DIRECTION_ANTI_CW;
+		if (!g_yawCalibrated) {
+			setYawQeiIndexReset(false);
+			g_qeiSeq++;
+			g_yawTurns = 0;
+			g_qeiLastCount = getYawQeiPosition();
+			g_qeiSeq++;
+			setYawResyncReference(&g_yawResync, YAW_REF_ENTER, direction, 0);
+			g_yawCalibrated = true;
 		} else {
-			direction = DIRECTION_ANTI_CW;
+			correction = yawResyncUpdate(&g_yawResync, YAW_REF_ENTER, direction,
+					getYawQeiPosition());
+			if (correction != 0) {
+				shiftYawQeiPosition(-correction);
+			}
 		}
 	}
+	if (events & YAW_QEI_EVENT_TIMER) {
+		unwrapYawQei();
+	}
+	if (events & YAW_QEI_EVENT_ERROR) {
+		g_yawPhaseErrors++;
+	}
+}
+
 
-	if (direction == DIRECTION_CW) {
-		pinChangeInterruptCount++;
-	} else if (direction == DIRECTION_ANTI_CW) {
-		pinChangeInterruptCount--;
+/* *****************************************************************************
+ * getYawIllegalTransitions: returns the number of quadrature transitions in
+ * which both channels changed at once, so the direction was unknown. A rising
+ * count indicates missed edges or a noisy signal.
+ */
+uint32_t
+getYawIllegalTransitions (void)
+{
+	return g_yawPhaseErrors;
+}
+#else
+/* *****************************************************************************
+ * readYawState: reads both quadrature channels (which share a port) at once,
+ * and returns them as an AB state.
+ */
+static uint32_t
+readYawState (void)
+{
+	uint32_t pins = GPIOPinRead(YAW_BASE_A, YAW_PIN_A | YAW_PIN_B);
+	return QUAD_STATE((pins & YAW_PIN_A) != 0, (pins & YAW_PIN_B) != 0);
+}
+
+
+/* *****************************************************************************
+ * shiftYawPosition: adds shift to the yaw position. The recorded edge
+ * positions are shifted with it, so the rate is unaffected.
+ */
+static void
+shiftYawPosition (int32_t shift)
+{
+	int32_t count = (g_pinChangeInterruptCount + shift) % INTERRUPTS_PER_REV;
+	uint32_t i;
+
+	if (count < 0) {
+		count += INTERRUPTS_PER_REV;
+	}
+
+	g_edgeSeq++;
+	g_yawPosition += shift;
+	for (i = 0; i < YAW_EDGE_HISTORY; i++) {
+		g_edgePosition[i] += shift;
 	}
+	g_rateWindowPosition += shift;
+	g_edgeSeq++;
+
+	g_pinChangeInterruptCount = count;
+}
+
+
+/* *****************************************************************************
+ * zeroYawPosition: sets the yaw position to zero at the reference point.
+ */
+static void
+zeroYawPosition (void)
+{
+	shiftYawPosition(-g_yawPosition);
+}
+
+
+/* *****************************************************************************
+ * recordYawEdge: timestamps an edge, and records the net edge count after it.
+ */
+static void
+recordYawEdge (int32_t delta)
+{
+	uint32_t slot = g_edgeCount & (YAW_EDGE_HISTORY - 1);
+
+	g_edgeSeq++;
+	g_yawPosition += delta;
+	g_edgeTime[slot] = TimerValueGet(YAW_TIMER_BASE, YAW_TIMER);
+	g_edgePosition[slot] = g_yawPosition;
+	g_edgeCount++;
+	g_edgeSeq++;
+}
+
+
+/* *****************************************************************************
+ * pinChangeIntHandler: carries out quadrature decoding using the two input
+ * signals A and B. Increments g_pinChangeInterruptCount when clockwise movement
+ * is read, decrements it for anticlockwise.
+ */
+void
+pinChangeIntHandler (void)
+{
+	GPIOIntClear(YAW_BASE_A, YAW_PIN_A | YAW_PIN_B);
+
+	int32_t delta = quadDecoderUpdate(&g_yawDecoder, readYawState());
+	int16_t pinChangeInterruptCount = g_pinChangeInterruptCount + delta;
 
 	if (pinChangeInterruptCount >= INTERRUPTS_PER_REV) {
 		pinChangeInterruptCount -= INTERRUPTS_PER_REV;
@@ -101,22 +342,180 @@ pinChangeIntHandler (void)
 		pinChangeInterruptCount += INTERRUPTS_PER_REV;
 	}
 
-	g_stateA = newStateA;
-	g_stateB = newStateB;
-	g_currentDirection = direction;
+	if (delta != 0) {
+		g_currentDirection = (delta > 0) ? DIRECTION_CW : DIRECTION_ANTI_CW;
+		recordYawEdge(delta);
+	}
 	g_pinChangeInterruptCount = pinChangeInterruptCount;
 }
 
+
 /* *****************************************************************************
- * yawRefIntHandler: calibrates yaw readings by setting pinChangeInterruptCount
- * to zero. Should be called once - as soon as a reference signal is applied.
+ * getYawIllegalTransitions: returns the number of quadrature transitions in
+ * which both channels changed at once, so the direction was unknown. A rising
+ * count indicates missed edges or a noisy signal.
+ */
+uint32_t
+getYawIllegalTransitions (void)
+{
+	return g_yawDecoder.illegalCount;
+}
+
+/* *****************************************************************************
+ * edgesToCentidegrees: converts edges over ticks of the edge timer to a rate
+ * in centidegrees per second.
+ */
+static int32_t
+edgesToCentidegrees (int32_t edges, uint32_t ticks)
+{
+	if (ticks == 0) {
+		return 0;
+	}
+	return (int32_t)(((int64_t)edges * CENTIDEGREES_PER_REV * g_yawTimerRate) /
+			((int64_t)INTERRUPTS_PER_REV * ticks));
+}
+
+
+/* *****************************************************************************
+ * measureYawRate: estimates the yaw rate from the edge timestamps. Counts
+ * edges over the time since the previous call if there are enough of them,
+ * otherwise measures the period of the latest edges. Between edges, the period
+ * is taken as at least the time since the last edge, so the rate decays
+ * towards zero when rotation stops, and reads zero after YAW_RATE_TIMEOUT_MS.
+ * Once stopped, the rate is measured from the edges after the next start only.
+ * Must be called at least once per timer period (about 214 s).
+ */
+static int32_t
+measureYawRate (void)
+{
+	uint32_t seq;
+	uint32_t now;
+	uint32_t count;
+	bool restarted;
+	uint32_t start;
+	uint32_t first; // oldest edge kept since the start
+	uint32_t lastTime;
+	uint32_t refTime;
+	uint32_t startTime;
+	int32_t lastPosition;
+	int32_t refPosition;
+	int32_t startPosition;
+	int32_t span;
+	uint32_t ageLimit = (g_yawTimerRate / 1000) * YAW_RATE_TIMEOUT_MS + 1;
+
+	// Copy the latest edges, retrying if an edge was recorded meanwhile. Edges
+	// from before the latest start from rest are not used: their timestamps
+	// may be a whole timer period old, and so look recent.
+	do {
+		seq = g_edgeSeq;
+		now = TimerValueGet(YAW_TIMER_BASE, YAW_TIMER);
+		count = g_edgeCount;
+		restarted = (count != g_edgeAgeCount) && (g_edgeAge >= ageLimit);
+		start = restarted ? g_edgeAgeCount : g_edgeStartCount;
+		span = (count - start > YAW_RATE_PERIOD_EDGES) ? YAW_RATE_PERIOD_EDGES
+				: (int32_t)(count - start) - 1;
+		lastTime = g_edgeTime[(count - 1) & (YAW_EDGE_HISTORY - 1)];
+		lastPosition = g_edgePosition[(count - 1) & (YAW_EDGE_HISTORY - 1)];
+		refTime = g_edgeTime[(count - 1 - span) & (YAW_EDGE_HISTORY - 1)];
+		refPosition = g_edgePosition[(count - 1 - span) & (YAW_EDGE_HISTORY - 1)];
+		first = (count - start > YAW_EDGE_HISTORY) ? count - YAW_EDGE_HISTORY : start;
+		startTime = g_edgeTime[first & (YAW_EDGE_HISTORY - 1)];
+		startPosition = g_edgePosition[first & (YAW_EDGE_HISTORY - 1)];
+	} while ((seq & 1) || (seq != g_edgeSeq));
+
+	if (restarted) {
+		// Started from rest: time the window from the first new edge kept
+		g_edgeStartCount = start;
+		g_rateWindowTime = startTime;
+		g_rateWindowPosition = startPosition;
+	}
+
+	// Age the latest edge by the time since the previous call, restarting from
+	// its timestamp when a new edge has been recorded
+	uint32_t elapsed = g_rateCallTime - now; // Timer counts down
+	if (count != g_edgeAgeCount) {
+		g_edgeAgeCount = count;
+		g_edgeAge = 0;
+		elapsed = lastTime - now;
+	}
+	g_edgeAge = (elapsed < ageLimit - g_edgeAge) ? g_edgeAge + elapsed : ageLimit;
+	g_rateCallTime = now;
+
+	// High speed: count over the window since the previous call, timed from
+	// edge to edge so that partial edge intervals do not bias the rate
+	int32_t windowEdges = lastPosition - g_rateWindowPosition;
+	uint32_t windowTicks = g_rateWindowTime - lastTime; // Timer counts down
+	g_rateWindowTime = lastTime;
+	g_rateWindowPosition = lastPosition;
+	if ((windowEdges >= YAW_RATE_WINDOW_EDGES) || (windowEdges <= -YAW_RATE_WINDOW_EDGES)) {
+		return edgesToCentidegrees(windowEdges, windowTicks);
+	}
+
+	// Low speed: period of the latest edges
+	uint32_t sinceLast = g_edgeAge;
+	if ((span < 1) || (sinceLast >= ageLimit)) {
+		return 0;
+	}
+
+	int32_t edges = lastPosition - refPosition;
+	if ((edges != span) && (edges != -span)) {
+		// Direction changed within the span, so use the latest edge only
+		refTime = g_edgeTime[(count - 2) & (YAW_EDGE_HISTORY - 1)];
+		edges = lastPosition - g_edgePosition[(count - 2) & (YAW_EDGE_HISTORY - 1)];
+		span = 1;
+	}
+	uint32_t period = refTime - lastTime;
+	if (sinceLast * span > period) {
+		period = sinceLast * span; // Slower than the last edges suggest
+	}
+	return edgesToCentidegrees(edges, period);
+}
+
+
+/* *****************************************************************************
+ * initYawTimer: starts the free-running 32 bit timer used to timestamp edges.
+ */
+static void
+initYawTimer (void)
+{
+	SysCtlPeripheralEnable(YAW_TIMER_PERIPH);
+	TimerConfigure(YAW_TIMER_BASE, TIMER_CFG_PERIODIC);
+	TimerLoadSet(YAW_TIMER_BASE, YAW_TIMER, 0xFFFFFFFF);
+	TimerEnable(YAW_TIMER_BASE, YAW_TIMER);
+
+	g_yawTimerRate = SysCtlClockGet();
+	g_rateWindowTime = TimerValueGet(YAW_TIMER_BASE, YAW_TIMER);
+	g_rateWindowPosition = 0;
+	g_rateCallTime = g_rateWindowTime;
+	g_edgeAge = 0;
+	g_edgeAgeCount = 0;
+	g_edgeStartCount = 0;
+}
+
+
+/* *****************************************************************************
+ * yawRefIntHandler: called on both edges of the reference signal. The first
+ * edge calibrates yaw readings by setting the yaw position to zero. Later
+ * edges correct any drift through g_yawResync instead.
  */
 void
 yawRefIntHandler (void)
 {
+	yawRefEdge_t edge = yawRefActive_p() ? YAW_REF_ENTER : YAW_REF_LEAVE;
+	int32_t correction;
+
 	GPIOIntClear (YAW_BASE_REF, YAW_PIN_REF);
-	g_pinChangeInterruptCount = 0;
-	g_yawCalibrated = true;
+	if (!g_yawCalibrated) {
+		zeroYawPosition();
+		setYawResyncReference(&g_yawResync, edge, g_currentDirection, 0);
+		g_yawCalibrated = true;
+	} else {
+		correction = yawResyncUpdate(&g_yawResync, edge, g_currentDirection,
+				g_pinChangeInterruptCount);
+		if (correction != 0) {
+			shiftYawPosition(-correction);
+		}
+	}
 }
 
 /* *****************************************************************************
@@ -134,6 +533,9 @@ initReferencePin (void)
        GPIO_PIN_TYPE_STD_WPU);
 
     GPIOIntTypeSet (YAW_BASE_REF, YAW_PIN_REF, GPIO_BOTH_EDGES);
+    // Discard an edge latched while the pull-up settled, which would
+    // calibrate wherever the helicopter is
+    GPIOIntClear (YAW_BASE_REF, YAW_PIN_REF);
     GPIOIntEnable (YAW_BASE_REF, YAW_PIN_REF);
 	IntEnable (YAW_GPIO_INT_REF);
 }
@@ -168,6 +570,63 @@ initYawPins (void)
     IntEnable (YAW_GPIO_INT_A);
 	IntEnable (YAW_GPIO_INT_B);
 }
+#endif
+
+
+/* *****************************************************************************
+ * getYawPosition: returns the multi-turn yaw position in encoder counts,
+ * clockwise from the reference point or initial position. Not wrapped, so
+ * continuous rotation gives a continuously changing value.
+ */
+int32_t
+getYawPosition (void)
+{
+#if YAW_BACKEND == YAW_BACKEND_QEI
+	uint32_t seq;
+	int32_t turns;
+	uint32_t last;
+	uint32_t count;
+
+	do {
+		seq = g_qeiSeq;
+		turns = g_yawTurns;
+		last = g_qeiLastCount;
+		count = getYawQeiPosition();
+	} while ((seq & 1) || (seq != g_qeiSeq));
+
+	// Include any wrap since the last velocity timer event
+	turns += turnsSinceCount(last, count);
+	return turns * INTERRUPTS_PER_REV + (int32_t)count;
+#else
+	return g_yawPosition;
+#endif
+}
+
+
+/* *****************************************************************************
+ * getYawCount: returns the yaw position in encoder counts, wrapped to
+ * [0, INTERRUPTS_PER_REV).
+ */
+uint16_t
+getYawCount (void)
+{
+#if YAW_BACKEND == YAW_BACKEND_QEI
+	return getYawQeiPosition();
+#else
+	return g_pinChangeInterruptCount;
+#endif
+}
+
+
+/* *****************************************************************************
+ * getYawCentidegrees: returns the current yaw in hundredths of a degree, in
+ * [0, 36000). Uses a multiply-shift in place of a divide.
+ */
+uint16_t
+getYawCentidegrees (void)
+{
+	return (getYawCount() * YAW_CENTIDEGREE_SCALE) >> YAW_SCALE_SHIFT;
+}
 
 
 /* *****************************************************************************
@@ -178,29 +637,72 @@ initYawPins (void)
 uint16_t
 getCurrentYaw (void)
 {
-	return (g_pinChangeInterruptCount * 360) / INTERRUPTS_PER_REV;
+	return (getYawCount() * YAW_DEGREE_SCALE) >> YAW_SCALE_SHIFT;
+}
+
+
+/* *****************************************************************************
+ * getYawRate: returns the rate of clockwise rotation in centidegrees per
+ * second. With YAW_BACKEND_GPIO, each encoder edge is timestamped: at low
+ * speeds the rate is measured from the period of the latest edges, and at high
+ * speeds (at least YAW_RATE_WINDOW_EDGES since the previous call) from the
+ * edges counted over the time since the previous call. With YAW_BACKEND_QEI,
+ * the rate comes from the QEI velocity capture. Intended to be called at a
+ * regular rate, e.g. by the controller.
+ */
+int32_t
+getYawRate (void)
+{
+#if YAW_BACKEND == YAW_BACKEND_QEI
+	return (int32_t)(((int64_t)getYawQeiVelocity() * YAW_QEI_VELOCITY_RATE * CENTIDEGREES_PER_REV) /
+			INTERRUPTS_PER_REV);
+#else
+	return measureYawRate();
+#endif
+}
+
+
+/* *****************************************************************************
+ * getYawSlip: returns the mean drift corrected at each pass of the reference
+ * point, in hundredths of an encoder count per revolution.
+ */
+uint32_t
+getYawSlip (void)
+{
+	return getYawResyncSlip(&g_yawResync);
 }
 
 
 /* *****************************************************************************
- * disableYawRefInt: disables the yaw reference interrupt. May be used to
- * prevent unexpected behaviour where calculations are based on the yaw values
- * taken before calibration. Undone through a call to enableYawRefInt.
+ * disableYawRefInt: disables the yaw reference interrupt, so the yaw is
+ * neither calibrated nor corrected for drift at the reference point. Undone
+ * through a call to enableYawRefInt.
  */
 void
 disableYawRefInt (void)
 {
+#if YAW_BACKEND == YAW_BACKEND_QEI
+	setYawQeiIndexInt(false);
+#else
     GPIOIntDisable (YAW_BASE_REF, YAW_PIN_REF);
+#endif
 }
 
 
 /* *****************************************************************************
  * enableYawRefInt: enables the yaw reference interrupt. Called in initYawmeter.
+ * A reference edge seen while it was disabled is discarded rather than
+ * reported on enabling.
  */
 void
 enableYawRefInt (void)
 {
+#if YAW_BACKEND == YAW_BACKEND_QEI
+	setYawQeiIndexInt(true);
+#else
+    GPIOIntClear (YAW_BASE_REF, YAW_PIN_REF);
     GPIOIntEnable (YAW_BASE_REF, YAW_PIN_REF);
+#endif
 }
 
 
@@ -211,10 +713,15 @@ enableYawRefInt (void)
 void
 initYawmeter (void)
 {
+	initYawResync(&g_yawResync, YAW_RESYNC_MAX_CORRECTION, YAW_RESYNC_DEADBAND);
+#if YAW_BACKEND == YAW_BACKEND_QEI
+	initYawQei(INTERRUPTS_PER_REV, YAW_QEI_VELOCITY_RATE, yawQeiIntHandler);
+#else
+	initYawTimer();
 	initReferencePin();
 	initYawPins();
 	g_pinChangeInterruptCount = 0;
 
-	g_stateA = (GPIOPinRead (YAW_BASE_A, YAW_PIN_A) & YAW_PIN_A) == YAW_PIN_A;
-    g_stateB = (GPIOPinRead (YAW_BASE_B, YAW_PIN_B) & YAW_PIN_B) == YAW_PIN_B;
+	initQuadDecoder(&g_yawDecoder, readYawState());
+#endif
 }
@@ -14,16 +14,66 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+/* *****************************************************************************
+ * Backend, selected at build time
+ */
+#define YAW_BACKEND_GPIO 0 // quadrature decoded in a GPIO interrupt on every edge
+#define YAW_BACKEND_QEI 1 // edges counted by the QEI1 peripheral
+#ifndef YAW_BACKEND
+#define YAW_BACKEND YAW_BACKEND_GPIO
+#endif
+
+/* *****************************************************************************
+ * Pin budget
+ * The yaw inputs share the LaunchPad headers with the motors (motors.h), the
+ * buttons (buttons.h), the altimeter (PE4) and the Orbit OLED (PD0, PD1, PD3,
+ * PD7, PE1, PE2, PE5):
+ *
+ *              channel A   channel B   reference   main PWM    tail PWM
+ * GPIO         PB0         PB1         PC4         PC5 M0PWM7  PF1 M1PWM5
+ * QEI          PC5 PhA1    PC6 PhB1    PC4 IDX1    PF2 M1PWM6  PF1 M1PWM5
+ *
+ * QEI0 is not an option: its pins are PD6/PD7/PD3, which clash with the OLED,
+ * or PF0/PF1/PF4, which clash with the buttons and the tail PWM. QEI1 needs
+ * PC5, so with YAW_BACKEND_QEI the main PWM moves from PC5 to PF2 (J4-01, also
+ * the blue LED). yawmeter.c checks at compile time that no yaw input shares a
+ * pin with a PWM output.
+ */
+
 /* *****************************************************************************
  * Peripheral definitions
  */
+#if YAW_BACKEND == YAW_BACKEND_QEI
+// QEI1 takes its index from the reference signal on PC4, so the quadrature
+// channels are rewired from PB0/PB1 to PC5/PC6, and the main motor PWM from
+// PC5 to PF2.
+#define YAW_QEI_BASE QEI1_BASE
+#define YAW_PERIPH_QEI SYSCTL_PERIPH_QEI1
+#define YAW_QEI_VELOCITY_RATE 100 // velocity captures per second
+
+// Quadrature channel A - PC5
+#define YAW_PIN_A GPIO_PIN_5
+#define YAW_BASE_A GPIO_PORTC_BASE
+#define YAW_PINMUX_A GPIO_PC5_PHA1
+
+// Quadrature channel B - PC6
+#define YAW_PIN_B GPIO_PIN_6
+#define YAW_BASE_B GPIO_PORTC_BASE
+#define YAW_PINMUX_B GPIO_PC6_PHB1
+
+// Yaw reference signal (index) - PC4
+#define YAW_PIN_REF GPIO_PIN_4
+#define YAW_PINMUX_REF GPIO_PC4_IDX1
+#define YAW_PERIPH_REF SYSCTL_PERIPH_GPIOC
+#define YAW_BASE_REF GPIO_PORTC_BASE
+#else
 // Quadrature channel A - PB0
 #define YAW_PIN_A GPIO_PIN_0
 #define YAW_PERIPH_A SYSCTL_PERIPH_GPIOB
 #define YAW_BASE_A GPIO_PORTB_BASE
 #define YAW_GPIO_INT_A INT_GPIOB
 
-// Quadrature channel B - PB1
+// Quadrature channel B - PB1, on the same port as channel A
 #define YAW_PIN_B GPIO_PIN_1
 #define YAW_PERIPH_B SYSCTL_PERIPH_GPIOB
 #define YAW_BASE_B GPIO_PORTB_BASE
@@ -35,6 +85,13 @@
 #define YAW_BASE_REF GPIO_PORTC_BASE
 #define YAW_GPIO_INT_REF INT_GPIOC
 
+// Free-running timer for edge timestamps
+#define YAW_TIMER_PERIPH SYSCTL_PERIPH_TIMER2
+#define YAW_TIMER_BASE TIMER2_BASE
+#define YAW_TIMER TIMER_A
+#endif
+#define YAW_REF_ACTIVE_LEVEL 0 // reference signal is active low (pulled up when inactive)
+
 /* *****************************************************************************
  * Optical encoder calculations
  */
@@ -42,6 +99,32 @@
 #define SLOTS_PER_REV 112
 #define INTERRUPTS_PER_SLOT 2
 #define INTERRUPTS_PER_REV (INTERRUPTS_PER_SLOT * SLOTS_PER_REV * QUADRATURE_SENSOR_COUNT)
+#define CENTIDEGREES_PER_REV 36000
+
+// Counts to angle by multiply-shift. Scales are rounded; for every count in
+// [0, INTERRUPTS_PER_REV) the result equals the truncating division.
+#define YAW_SCALE_SHIFT 16
+#define YAW_DEGREE_SCALE ((((uint32_t)360 << YAW_SCALE_SHIFT) + INTERRUPTS_PER_REV / 2) / INTERRUPTS_PER_REV)
+#define YAW_CENTIDEGREE_SCALE ((((uint32_t)CENTIDEGREES_PER_REV << YAW_SCALE_SHIFT) + INTERRUPTS_PER_REV / 2) / INTERRUPTS_PER_REV)
+
+// Conversions for constant angles and for display, rounded to nearest
+#define YAW_DEGREES_TO_COUNTS(degrees) (((degrees) * INTERRUPTS_PER_REV + 180) / 360)
+#define YAW_COUNTS_TO_DEGREES(counts) (((counts) * 360 + INTERRUPTS_PER_REV / 2) / INTERRUPTS_PER_REV)
+
+/* *****************************************************************************
+ * Yaw rate estimation (YAW_BACKEND_GPIO)
+ */
+#define YAW_EDGE_HISTORY_LOG2 3 // edge timestamps kept
+#define YAW_EDGE_HISTORY (1 << YAW_EDGE_HISTORY_LOG2)
+#define YAW_RATE_PERIOD_EDGES 4 // edges per period measurement, one quadrature cycle
+#define YAW_RATE_WINDOW_EDGES 8 // edges between getYawRate calls to count over the window instead
+#define YAW_RATE_TIMEOUT_MS 250 // no edge for this long reads as stationary
+
+/* *****************************************************************************
+ * Drift correction at the reference point
+ */
+#define YAW_RESYNC_MAX_CORRECTION 4 // counts corrected per reference edge
+#define YAW_RESYNC_DEADBAND 1 // counts of jitter in the reference edges left alone
 
 /* *****************************************************************************
  * Constants
@@ -56,12 +139,44 @@ bool
 yawCalibrated_p (void);
 
 /* *****************************************************************************
- * yawDifference: returns the smallest (in magnitude) angle from between the
- * two given bearings. Measured from current to reference. Result will fall in
- * [-180, 180].
+ * restoreYawCalibration: for a warm start where the helicopter is known to have
+ * landed at the reference point. If the reference signal is currently active,
+ * this confirms it: the yaw is zeroed and marked calibrated, and true is
+ * returned. Otherwise the yaw must be calibrated by finding the reference.
+ */
+bool
+restoreYawCalibration (void);
+
+/* *****************************************************************************
+ * yawDifference: returns the smallest (in magnitude) difference between the
+ * two given positions, in encoder counts. Measured from current to reference.
+ * Positions may be wrapped or multi-turn. Result will fall in
+ * [-INTERRUPTS_PER_REV / 2, INTERRUPTS_PER_REV / 2].
+ */
+int32_t
+yawDifference (int32_t reference, int32_t current);
+
+/* *****************************************************************************
+ * getYawPosition: returns the multi-turn yaw position in encoder counts,
+ * clockwise from the reference point or initial position. Not wrapped, so
+ * continuous rotation gives a continuously changing value.
  */
 int32_t
-yawDifference (uint16_t reference, uint16_t current);
+getYawPosition (void);
+
+/* *****************************************************************************
+ * getYawCount: returns the yaw position in encoder counts, wrapped to
+ * [0, INTERRUPTS_PER_REV).
+ */
+uint16_t
+getYawCount (void);
+
+/* *****************************************************************************
+ * getYawCentidegrees: returns the current yaw in hundredths of a degree, in
+ * [0, 36000). Uses a multiply-shift in place of a divide.
+ */
+uint16_t
+getYawCentidegrees (void);
 
 /* *****************************************************************************
  * getCurrentYaw: returns the current yaw as measured by quadrature decoding.
@@ -72,15 +187,44 @@ uint16_t
 getCurrentYaw (void);
 
 /* *****************************************************************************
- * disableYawRefInt: disables the yaw reference interrupt. May be used to
- * prevent unexpected behaviour where calculations are based on the yaw values
- * taken before calibration. Undone through a call to enableYawRefInt.
+ * getYawIllegalTransitions: returns the number of quadrature transitions in
+ * which both channels changed at once, so the direction was unknown. A rising
+ * count indicates missed edges or a noisy signal.
+ */
+uint32_t
+getYawIllegalTransitions (void);
+
+/* *****************************************************************************
+ * getYawRate: returns the rate of clockwise rotation in centidegrees per
+ * second. With YAW_BACKEND_GPIO, each encoder edge is timestamped: at low
+ * speeds the rate is measured from the period of the latest edges, and at high
+ * speeds (at least YAW_RATE_WINDOW_EDGES since the previous call) from the
+ * edges counted over the time since the previous call. With YAW_BACKEND_QEI,
+ * the rate comes from the QEI velocity capture. Intended to be called at a
+ * regular rate, e.g. by the controller.
+ */
+int32_t
+getYawRate (void);
+
+/* *****************************************************************************
+ * getYawSlip: returns the mean drift corrected at each pass of the reference
+ * point, in hundredths of an encoder count per revolution.
+ */
+uint32_t
+getYawSlip (void);
+
+/* *****************************************************************************
+ * disableYawRefInt: disables the yaw reference interrupt, so the yaw is
+ * neither calibrated nor corrected for drift at the reference point. Undone
+ * through a call to enableYawRefInt.
  */
 void
 disableYawRefInt (void);
 
 /* *****************************************************************************
  * enableYawRefInt: enables the yaw reference interrupt. Called in initYawmeter.
+ * A reference edge seen while it was disabled is discarded rather than
+ * reported on enabling.
  */
 void
 enableYawRefInt (void);